@@ -0,0 +1,231 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#include <flecs.h>
+#include <SFML/System/Vector2.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "Core/Components/CircleRenderable.h"
+#include "Core/Components/ScreenBoundaries.h"
+#include "Core/Components/Transform.h"
+#include "Core/Utilities/JobSystem.h"
+#include "Core/Utilities/Logger.h"
+#include "PhysicsModule/Components/CircleCollider.h"
+#include "PhysicsModule/Components/Damping.h"
+#include "PhysicsModule/Components/Drag.h"
+#include "PhysicsModule/Components/Gravity.h"
+#include "PhysicsModule/Components/IntegrationStats.h"
+#include "PhysicsModule/Components/Restitution.h"
+#include "PhysicsModule/Components/RigidBody.h"
+#include "PhysicsModule/Components/SpatialReorder.h"
+#include "PhysicsModule/PhysicsModule.h"
+
+namespace {
+constexpr float SCREEN_PADDING = 5.f;
+constexpr float SCREEN_WIDTH = 1920.f;
+constexpr float SCREEN_HEIGHT = 1080.f;
+constexpr float PARTICLE_RADIUS = 20.f;
+constexpr float MAX_INITIAL_SPEED = 2000.f;
+
+constexpr int DEFAULT_STEPS = 1000;
+constexpr float FIXED_DELTA_TIME = 1.f / 144.f;
+
+/**
+ * Everything needed to build one world. The sweep copies the base scene and only changes
+ * the physics parameters, so every world starts from exactly the same bodies.
+ */
+struct SceneDescription {
+  std::uint32_t seed = 42;
+  int particleCount = 256;
+  float restitution = .9f;
+  Damping damping;
+  Drag drag;
+  bool useDrag = false;
+};
+
+// Parameter values swept by the batch, every combination becomes one world
+constexpr float RESTITUTIONS[] = {.5f, .7f, .9f, 1.f};
+constexpr float DAMPING_COEFFICIENTS[] = {0.f, .5f, 1.15f, 2.f};
+constexpr Drag DRAGS[] = {{0.f, 0.f}, {.05f, .001f}, {.1f, .002f}};
+
+struct WorldMetrics {
+  float kineticEnergy = 0.f;
+  float meanSpeed = 0.f;
+  sf::Vector2f meanPosition;
+  std::uint64_t integrationSubsteps = 0;
+  std::uint64_t sortCount = 0;
+  double totalSortMilliseconds = 0.;
+  double wallMilliseconds = 0.;
+};
+
+struct BatchEntry {
+  SceneDescription scene;
+  std::unique_ptr<flecs::world> world;
+  WorldMetrics metrics;
+};
+
+std::vector<SceneDescription> BuildSweep(const SceneDescription& base) {
+  std::vector<SceneDescription> scenes;
+  for (const float restitution : RESTITUTIONS) {
+    for (const float coefficient : DAMPING_COEFFICIENTS) {
+      for (const Drag& drag : DRAGS) {
+        SceneDescription scene = base;
+        scene.restitution = restitution;
+        scene.damping.coefficient = coefficient;
+        scene.drag = drag;
+        scene.useDrag = drag.k1 > 0.f || drag.k2 > 0.f;
+        scenes.push_back(scene);
+      }
+    }
+  }
+  return scenes;
+}
+
+std::unique_ptr<flecs::world> CreateWorld(const SceneDescription& scene) {
+  auto world = std::make_unique<flecs::world>();
+
+  PhysicsModule::Register(*world);
+
+  world->set<ScreenBoundaries>(
+      {sf::FloatRect{{SCREEN_PADDING, SCREEN_PADDING},
+                     {SCREEN_WIDTH - 2 * SCREEN_PADDING, SCREEN_HEIGHT - 2 * SCREEN_PADDING}}});
+  world->set<Restitution>({scene.restitution});
+  world->set<IntegrationStats>({});
+  world->set<SpatialReorder>({});
+
+  // No PhysicsSettings job system: the batch already runs one world per thread, contacts are solved serially
+
+  // Each world owns its generator, the global Random utility is not safe to share between threads
+  std::mt19937 gen(scene.seed);
+  std::uniform_real_distribution<float> x(PARTICLE_RADIUS + SCREEN_PADDING,
+                                          SCREEN_WIDTH - PARTICLE_RADIUS - SCREEN_PADDING);
+  std::uniform_real_distribution<float> y(PARTICLE_RADIUS + SCREEN_PADDING,
+                                          SCREEN_HEIGHT - PARTICLE_RADIUS - SCREEN_PADDING);
+  std::uniform_real_distribution<float> speed(-MAX_INITIAL_SPEED, MAX_INITIAL_SPEED);
+
+  for (int i = 0; i < scene.particleCount; ++i) {
+    const auto particle = world->entity()
+                              .set<CircleRenderable>({})
+                              .set<Transform>({{x(gen), y(gen)}})
+                              .set<RigidBody>({.velocity = {speed(gen), speed(gen)}})
+                              .set<CircleCollider>({PARTICLE_RADIUS})
+                              .set<Damping>(scene.damping)
+                              .set<Gravity>({});
+
+    if (scene.useDrag)
+      particle.set<Drag>(scene.drag);
+
+    auto& shape = particle.get_mut<CircleRenderable>().shape;
+    shape.setRadius(PARTICLE_RADIUS);
+    shape.setOrigin({PARTICLE_RADIUS, PARTICLE_RADIUS});
+  }
+
+  return world;
+}
+
+void RunWorld(BatchEntry& entry, const int steps) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int step = 0; step < steps; ++step) {
+    entry.world->progress(FIXED_DELTA_TIME);
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  WorldMetrics& metrics = entry.metrics;
+  metrics.wallMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+  metrics.integrationSubsteps = entry.world->get<IntegrationStats>().totalSubsteps;
+  const auto& reorder = entry.world->get<SpatialReorder>();
+  metrics.sortCount = reorder.sortCount;
+  metrics.totalSortMilliseconds = reorder.totalSortMilliseconds;
+
+  int count = 0;
+  entry.world->query<const Transform, const RigidBody>().each([&](const Transform& t, const RigidBody& b) {
+    if (b.inverseMass > 0.f)
+      metrics.kineticEnergy += .5f * b.velocity.lengthSquared() / b.inverseMass;
+    metrics.meanSpeed += b.velocity.length();
+    metrics.meanPosition += t.position;
+    ++count;
+  });
+
+  if (count > 0) {
+    metrics.meanSpeed /= static_cast<float>(count);
+    metrics.meanPosition /= static_cast<float>(count);
+  }
+}
+
+void WriteTable(std::ostream& out, const std::vector<BatchEntry>& entries, const int steps) {
+  out << "world,seed,particles,steps,restitution,damping,drag_k1,drag_k2,kinetic_energy,mean_speed,mean_x,mean_y,"
+         "integration_substeps,sort_count,sort_ms,wall_ms\n";
+  for (std::size_t i = 0; i < entries.size(); ++i) {
+    const auto& [scene, world, metrics] = entries[i];
+    out << i << ',' << scene.seed << ',' << scene.particleCount << ',' << steps << ',' << scene.restitution << ','
+        << scene.damping.coefficient << ',' << (scene.useDrag ? scene.drag.k1 : 0.f) << ','
+        << (scene.useDrag ? scene.drag.k2 : 0.f) << ',' << metrics.kineticEnergy << ',' << metrics.meanSpeed << ','
+        << metrics.meanPosition.x << ',' << metrics.meanPosition.y << ',' << metrics.integrationSubsteps << ','
+        << metrics.sortCount << ',' << metrics.totalSortMilliseconds << ',' << metrics.wallMilliseconds << '\n';
+  }
+}
+
+int ParseInt(const std::string_view text, const int fallback) {
+  int value = 0;
+  const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+  if (ec != std::errc{} || ptr != text.data() + text.size() || value <= 0) {
+    LOG_WARN("Invalid number '{}', using {}", text, fallback);
+    return fallback;
+  }
+  return value;
+}
+}  // namespace
+
+/**
+ * Runs a parameter sweep of the physics scene, one independent flecs world per combination,
+ * and writes one CSV row of metrics per world.
+ *
+ * Usage: BatchRunner [steps] [threads] [output.csv]
+ */
+int main(const int argc, char* argv[]) {
+  const int steps = argc > 1 ? ParseInt(argv[1], DEFAULT_STEPS) : DEFAULT_STEPS;
+  const unsigned threads = argc > 2 ? static_cast<unsigned>(ParseInt(argv[2], 1))
+                                    : std::max(std::thread::hardware_concurrency(), 1u);
+
+  std::vector<BatchEntry> entries;
+  for (const auto& scene : BuildSweep({})) {
+    entries.push_back({.scene = scene});
+  }
+
+  // Worlds are created and destroyed on this thread, flecs' OS API setup is not thread-safe.
+  // Stepping them is: each job only ever touches its own world.
+  for (auto& entry : entries) {
+    entry.world = CreateWorld(entry.scene);
+  }
+
+  LOG_INFO("Running {} worlds for {} steps on {} threads", entries.size(), steps, threads);
+
+  const auto start = std::chrono::steady_clock::now();
+  JobSystem jobs(threads);
+  jobs.ParallelFor(entries.size(), [&](const std::size_t i) { RunWorld(entries[i], steps); });
+  const auto end = std::chrono::steady_clock::now();
+
+  LOG_INFO("Batch done in {:.1f} ms", std::chrono::duration<double, std::milli>(end - start).count());
+
+  if (argc > 3) {
+    std::ofstream file(argv[3]);
+    if (!file) {
+      LOG_ERROR("Unable to open {}", argv[3]);
+      return 1;
+    }
+    WriteTable(file, entries, steps);
+  } else {
+    WriteTable(std::cout, entries, steps);
+  }
+
+  return 0;
+}
@@ -0,0 +1,57 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#include "Core/Utilities/FramePacer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+namespace {
+
+// The estimate jumps up to a slow frame right away and decays slowly, a spike costs one late frame at most
+constexpr int WORK_ESTIMATE_DECAY_PERCENT = 98;
+
+}  // namespace
+
+FramePacer::FramePacer(const float framesPerSecond)
+    : period(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1. / framesPerSecond))),
+      deadline(Clock::now() + period),
+      frameStart(Clock::now()) {
+  assert(framesPerSecond > 0.f);
+}
+
+void FramePacer::WaitForFrameStart() {
+  SleepUntil(deadline - workEstimate - SAFETY_MARGIN);
+  frameStart = Clock::now();
+}
+
+void FramePacer::EndFrame() {
+  const auto now = Clock::now();
+  const auto work = now - frameStart;
+  workEstimate = std::max(work, workEstimate * WORK_ESTIMATE_DECAY_PERCENT / 100);
+
+  // Never let a late frame pile up debt, restart the schedule from now
+  deadline += period;
+  if (deadline < now)
+    deadline = now + period;
+}
+
+void FramePacer::WaitForFrameEnd() {
+  SleepUntil(deadline);
+
+  const auto now = Clock::now();
+  deadline += period;
+  if (deadline < now)
+    deadline = now + period;
+}
+
+void FramePacer::SleepUntil(const Clock::time_point time) {
+  // Coarse sleep while it is safe, the OS may oversleep by about a millisecond
+  for (auto now = Clock::now(); now < time - SPIN_THRESHOLD; now = Clock::now()) {
+    std::this_thread::sleep_for(time - SPIN_THRESHOLD - now);
+  }
+
+  while (Clock::now() < time) {
+    std::this_thread::yield();
+  }
+}
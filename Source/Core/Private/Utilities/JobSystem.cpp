@@ -0,0 +1,119 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#include "Core/Utilities/JobSystem.h"
+
+#include <algorithm>
+
+JobSystem::JobSystem(const unsigned threadCount) {
+  // the calling thread is one of the participants, so we only spawn the others
+  const unsigned workerCount = std::max(threadCount, 1u) - 1;
+
+  queues.reserve(workerCount);
+  for (unsigned i = 0; i < workerCount; ++i) {
+    queues.push_back(std::make_unique<WorkerQueue>());
+  }
+
+  workers.reserve(workerCount);
+  for (unsigned i = 0; i < workerCount; ++i) {
+    workers.emplace_back([this, i] { WorkerLoop(i); });
+  }
+}
+
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard lock(sleepMutex);
+    stopping = true;
+  }
+  wakeUp.notify_all();
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+void JobSystem::ParallelFor(const std::size_t count, const std::function<void(std::size_t)>& fn,
+                            std::size_t grain) {
+  if (count == 0)
+    return;
+
+  grain = std::max<std::size_t>(grain, 1);
+  const std::size_t chunkCount = (count + grain - 1) / grain;
+
+  // Nothing to share, run it on the calling thread
+  if (queues.empty() || chunkCount == 1) {
+    for (std::size_t i = 0; i < count; ++i) {
+      fn(i);
+    }
+    return;
+  }
+
+  std::atomic<std::size_t> remaining = chunkCount;
+  pendingJobs.fetch_add(chunkCount);
+
+  for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+    const std::size_t begin = chunk * grain;
+    const std::size_t end = std::min(begin + grain, count);
+
+    auto& queue = *queues[nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size()];
+    std::lock_guard lock(queue.mutex);
+    queue.jobs.emplace_back([&fn, &remaining, begin, end] {
+      for (std::size_t i = begin; i < end; ++i) {
+        fn(i);
+      }
+      remaining.fetch_sub(1, std::memory_order_release);
+    });
+  }
+
+  // Taking the lock makes sure no worker is between its predicate check and its wait
+  { std::lock_guard lock(sleepMutex); }
+  wakeUp.notify_all();
+
+  // Help until our own chunks are done, we may end up running jobs from someone else
+  while (remaining.load(std::memory_order_acquire) > 0) {
+    if (!TryRunJob(queues.size()))
+      std::this_thread::yield();
+  }
+}
+
+void JobSystem::WorkerLoop(const std::size_t queueIndex) {
+  while (true) {
+    if (TryRunJob(queueIndex))
+      continue;
+
+    std::unique_lock lock(sleepMutex);
+    wakeUp.wait(lock, [this] { return stopping || pendingJobs.load() > 0; });
+    if (stopping && pendingJobs.load() == 0)
+      return;
+  }
+}
+
+bool JobSystem::TryRunJob(const std::size_t ownQueue) {
+  Job job;
+
+  // Own queue first, newest job is the one most likely to be hot in cache
+  if (ownQueue < queues.size()) {
+    auto& queue = *queues[ownQueue];
+    std::lock_guard lock(queue.mutex);
+    if (!queue.jobs.empty()) {
+      job = std::move(queue.jobs.back());
+      queue.jobs.pop_back();
+    }
+  }
+
+  // Steal the oldest job of the other queues
+  for (std::size_t i = 1; !job && i <= queues.size(); ++i) {
+    auto& queue = *queues[(ownQueue + i) % queues.size()];
+    std::lock_guard lock(queue.mutex);
+    if (!queue.jobs.empty()) {
+      job = std::move(queue.jobs.front());
+      queue.jobs.pop_front();
+    }
+  }
+
+  if (!job)
+    return false;
+
+  pendingJobs.fetch_sub(1);
+  job();
+  return true;
+}
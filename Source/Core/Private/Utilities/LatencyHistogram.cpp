@@ -0,0 +1,53 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#include "Core/Utilities/LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+namespace {
+
+double ToMilliseconds(const LatencyHistogram::Duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+}  // namespace
+
+void LatencyHistogram::Record(const Duration latency) {
+  const auto bucket = static_cast<std::size_t>(std::max<Duration::rep>(latency / BUCKET_WIDTH, 0));
+  ++buckets[std::min(bucket, BUCKET_COUNT - 1)];
+
+  ++count;
+  total += latency;
+  min = std::min(min, latency);
+  max = std::max(max, latency);
+}
+
+void LatencyHistogram::Reset() { *this = {}; }
+
+LatencyHistogram::Duration LatencyHistogram::GetMean() const {
+  return count > 0 ? total / static_cast<Duration::rep>(count) : Duration::zero();
+}
+
+LatencyHistogram::Duration LatencyHistogram::GetPercentile(const double percentile) const {
+  if (count == 0)
+    return Duration::zero();
+
+  const auto rank =
+      static_cast<std::uint64_t>(std::ceil(std::clamp(percentile, 0., 100.) / 100. * static_cast<double>(count)));
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+    seen += buckets[i];
+    if (seen >= std::max<std::uint64_t>(rank, 1))
+      return std::min(BUCKET_WIDTH * static_cast<Duration::rep>(i + 1), max);
+  }
+
+  return max;
+}
+
+std::string LatencyHistogram::ToString() const {
+  return std::format("{} samples, mean {:.2f} ms, p50 {:.2f} ms, p90 {:.2f} ms, p99 {:.2f} ms, max {:.2f} ms", count,
+                     ToMilliseconds(GetMean()), ToMilliseconds(GetPercentile(50.)), ToMilliseconds(GetPercentile(90.)),
+                     ToMilliseconds(GetPercentile(99.)), ToMilliseconds(max));
+}
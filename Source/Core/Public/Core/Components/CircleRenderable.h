@@ -1,3 +1,7 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
 #include <SFML/Graphics/CircleShape.hpp>
 
 struct CircleRenderable {
@@ -0,0 +1,45 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+#include <chrono>
+
+/**
+ * Low-latency frame pacing.
+ *
+ * Instead of sleeping after the frame like a framerate limit does, the pacer waits before the frame and starts
+ * it as late as possible: right before the next deadline, minus the time the recent frames took. Input polled
+ * at the start of the frame is then displayed with the smallest possible delay.
+ *
+ * The wait sleeps for the bulk of the time and only spins, yielding, for the last SPIN_THRESHOLD where the
+ * sleep granularity of the OS is too coarse.
+ */
+class FramePacer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr Clock::duration SPIN_THRESHOLD = std::chrono::milliseconds(1);
+  static constexpr Clock::duration SAFETY_MARGIN = std::chrono::microseconds(500);
+
+  explicit FramePacer(float framesPerSecond);
+
+  // Blocks until the next frame should start
+  void WaitForFrameStart();
+
+  // Call right after the frame is displayed, measures how long the frame took
+  void EndFrame();
+
+  // Framerate limit behavior: sleeps after the displayed frame until its deadline. Use instead of
+  // WaitForFrameStart() and EndFrame() to compare both pacing modes with the same timer.
+  void WaitForFrameEnd();
+
+  [[nodiscard]] Clock::duration GetWorkEstimate() const { return workEstimate; }
+
+ private:
+  static void SleepUntil(Clock::time_point time);
+
+  Clock::duration period;
+  Clock::duration workEstimate = Clock::duration::zero();
+  Clock::time_point deadline;
+  Clock::time_point frameStart;
+};
@@ -0,0 +1,58 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * JobSystem is a small work-stealing thread pool.
+ *
+ * Every worker owns a queue: it pops its own jobs from the back and steals from the front of the other
+ * queues when it runs dry. The thread calling ParallelFor takes part in the work until all of its chunks
+ * are done, which also makes it safe to call ParallelFor from inside a job.
+ */
+class JobSystem {
+ public:
+  // threadCount includes the calling thread, a JobSystem of 1 thread runs everything inline
+  explicit JobSystem(unsigned threadCount = std::thread::hardware_concurrency());
+  ~JobSystem();
+
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+  /**
+   * Calls fn(index) for every index in [0, count), handed out to the workers in chunks of `grain` indices.
+   * Returns once every index has been processed.
+   */
+  void ParallelFor(std::size_t count, const std::function<void(std::size_t)>& fn, std::size_t grain = 1);
+
+  [[nodiscard]] unsigned GetThreadCount() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+ private:
+  using Job = std::function<void()>;
+
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  void WorkerLoop(std::size_t queueIndex);
+  bool TryRunJob(std::size_t ownQueue);
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues;
+  std::vector<std::thread> workers;
+
+  std::mutex sleepMutex;
+  std::condition_variable wakeUp;
+  std::atomic<std::size_t> pendingJobs = 0;
+  std::atomic<std::size_t> nextQueue = 0;
+  bool stopping = false;
+};
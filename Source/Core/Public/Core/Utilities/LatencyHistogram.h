@@ -0,0 +1,41 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * Fixed resolution histogram of durations, 100 microseconds per bucket up to 50 ms.
+ * Anything longer lands in the last bucket but still counts toward the max and the mean.
+ */
+class LatencyHistogram {
+ public:
+  using Duration = std::chrono::nanoseconds;
+
+  static constexpr Duration BUCKET_WIDTH = std::chrono::microseconds(100);
+  static constexpr std::size_t BUCKET_COUNT = 500;
+
+  void Record(Duration latency);
+  void Reset();
+
+  [[nodiscard]] std::uint64_t GetCount() const { return count; }
+  [[nodiscard]] Duration GetMin() const { return count > 0 ? min : Duration::zero(); }
+  [[nodiscard]] Duration GetMax() const { return max; }
+  [[nodiscard]] Duration GetMean() const;
+
+  // Upper bound of the bucket holding the given percentile, in [0, 100]
+  [[nodiscard]] Duration GetPercentile(double percentile) const;
+
+  // One line summary: count, mean, p50, p90, p99 and max in milliseconds
+  [[nodiscard]] std::string ToString() const;
+
+ private:
+  std::array<std::uint64_t, BUCKET_COUNT> buckets = {};
+  std::uint64_t count = 0;
+  Duration total = Duration::zero();
+  Duration min = Duration::max();
+  Duration max = Duration::zero();
+};
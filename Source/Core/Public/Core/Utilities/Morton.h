@@ -0,0 +1,43 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+/**
+ * Z-order (Morton) curve: interleaving the bits of x and y gives a 1D key where points close
+ * in 2D are mostly close in the key as well.
+ */
+namespace Morton {
+
+// Inserts a zero bit between each of the 32 bits of value
+constexpr std::uint64_t SpreadBits(const std::uint32_t value) {
+  std::uint64_t x = value;
+  x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+  x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+  x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+  x = (x | (x << 2)) & 0x3333333333333333ull;
+  x = (x | (x << 1)) & 0x5555555555555555ull;
+  return x;
+}
+
+constexpr std::uint64_t Encode(const std::uint32_t x, const std::uint32_t y) {
+  return SpreadBits(x) | (SpreadBits(y) << 1);
+}
+
+// Quantizes a position to cells of cellSize units, the bias keeps negative coordinates ordered
+inline std::uint64_t Encode(const float x, const float y, const float cellSize = 1.f) {
+  constexpr double BIAS = 2147483648.0;
+  constexpr double MAX = 4294967295.0;
+
+  const auto quantize = [cellSize](const float value) {
+    const double cell = std::floor(static_cast<double>(value) / cellSize) + BIAS;
+    // written so that NaN ends up in the first cell
+    return static_cast<std::uint32_t>(!(cell > 0.) ? 0. : (cell > MAX ? MAX : cell));
+  };
+
+  return Encode(quantize(x), quantize(y));
+}
+
+}  // namespace Morton
@@ -4,21 +4,37 @@
 #include <SFML/System/Angle.hpp>
 #include <SFML/System/Vector2.hpp>
 #include <SFML/Window/Keyboard.hpp>
+#include <SFML/Window/Mouse.hpp>
 #include <SFML/Window/WindowEnums.hpp>
 
-#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <memory>
+#include <string_view>
+#include <vector>
 
 #include "Core/Components/CircleRenderable.h"
 #include "Core/Components/ScreenBoundaries.h"
 #include "Core/Components/Transform.h"
 #include "Core/Components/VerticesRenderable.h"
 #include "Core/Themes/Nord.h"
+#include "Core/Utilities/FramePacer.h"
+#include "Core/Utilities/JobSystem.h"
+#include "Core/Utilities/LatencyHistogram.h"
+#include "Core/Utilities/Logger.h"
+#include "PhysicsModule/Components/CircleCollider.h"
 #include "PhysicsModule/Components/Damping.h"
 #include "PhysicsModule/Components/Drag.h"
 #include "PhysicsModule/Components/Gravity.h"
+#include "PhysicsModule/Components/PhysicsSettings.h"
+#include "PhysicsModule/Components/Restitution.h"
 #include "PhysicsModule/Components/RigidBody.h"
+#include "PhysicsModule/Components/SpatialIndex.h"
+#include "PhysicsModule/Components/SpatialReorder.h"
+#include "PhysicsModule/Components/TrajectoryRecorder.h"
 #include "PhysicsModule/PhysicsModule.h"
+#include "PhysicsModule/Spatial/SpatialQuery.h"
+#include "Trajectory/TrajectoryWriter.h"
 
 namespace {
 constexpr float SCREEN_PADDING = 5.f;
@@ -27,6 +43,7 @@ constexpr float SCREEN_HEIGHT = 1080.f;
 constexpr float PARTICLE_RADIUS = 20.f;
 constexpr sf::Vector2f GRAVITY = {0.f, 9800.f};
 constexpr float RESTITUTION = 0.9f;
+constexpr float FRAMERATE = 144.f;
 
 struct MouseState {
   sf::Vector2i startPosition;
@@ -48,6 +65,7 @@ flecs::entity CreateParticleEntity(const flecs::world& world) {
                             .set<CircleRenderable>({})
                             .set<Transform>({{SCREEN_WIDTH / 2.f, SCREEN_HEIGHT / 2.f}})
                             .set<RigidBody>({})
+                            .set<CircleCollider>({PARTICLE_RADIUS})
                             //.set<Drag>({})
                             .set<Damping>({})
                             .set<Gravity>({});
@@ -74,32 +92,6 @@ flecs::entity CreateScreenBorder(const flecs::world& world) {
   return border;
 }
 
-auto HandleBoundaryCollision() {
-  return [](const flecs::iter& it, size_t, const CircleRenderable& c, Transform& t, RigidBody& p) {
-    const auto screenBounds = it.world().get<ScreenBoundaries>().bounds;
-    const auto radius = c.shape.getRadius();
-    bool collided = false;
-
-    if (t.position.x - radius < screenBounds.position.x ||
-        t.position.x + radius > screenBounds.position.x + screenBounds.size.x) {
-      collided = true;
-      p.velocity.x *= -1;
-      t.position.x = std::clamp(t.position.x, screenBounds.position.x + radius,
-                                screenBounds.position.x + screenBounds.size.x - radius);
-    } else if (t.position.y - radius < screenBounds.position.y ||
-               t.position.y + radius > screenBounds.position.y + screenBounds.size.y) {
-      collided = true;
-      p.velocity.y *= -1;
-      t.position.y = std::clamp(t.position.y, screenBounds.position.y + radius,
-                                screenBounds.position.y + screenBounds.size.y - radius);
-    }
-
-    // Restitution
-    if (collided)
-      p.velocity *= RESTITUTION;
-  };
-}
-
 auto DrawVertices(sf::RenderWindow& window) {
   return [&window](const VerticesRenderable& v) {
     window.draw(v.vertices.data(), v.vertices.size(), v.primitiveType);
@@ -130,6 +122,20 @@ auto ProcessLifeTimeOneFrame() {
   };
 }
 
+void HighlightParticleUnderMouse(const flecs::world& world, const sf::Event::MouseButtonPressed* mousePressed) {
+  const auto picked = SpatialQuery::PointPick(world, sf::Vector2f(mousePressed->position));
+  if (!picked)
+    return;
+
+  const flecs::entity particle(world, *picked);
+  if (!particle.has<CircleRenderable>())
+    return;
+
+  // Toggle the highlight
+  auto& shape = particle.get_mut<CircleRenderable>().shape;
+  shape.setFillColor(shape.getFillColor() == NordTheme::Aurora1 ? NordTheme::Frost1 : NordTheme::Aurora1);
+}
+
 void ShotParticleOnMouseReleased(const flecs::world& world, const sf::Event::MouseButtonReleased* mouseReleased) {
   // Record the position of the release
   const auto startPosition = world.get<MouseState>().startPosition;
@@ -164,14 +170,54 @@ void UpdateThrowLine(const flecs::world& world, const sf::Event::MouseMoved* mou
       sf::Vertex{.position = sf::Vector2f(currentPosition), .color = NordTheme::Frost1});
 }
 
-int main() {
+void StartRecording(const flecs::world& world, const int argc, char* argv[]) {
+  const char* path = nullptr;
+  auto encoding = TrajectoryEncoding::Raw;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view argument = argv[i];
+    if (argument == "--record" && i + 1 < argc) {
+      path = argv[++i];
+    } else if (argument == "--quantize") {
+      encoding = TrajectoryEncoding::Quantized16;
+    }
+  }
+
+  if (!path)
+    return;
+
+  std::shared_ptr writer = TrajectoryWriter::Open(path, encoding);
+  if (!writer)
+    return;
+
+  LOG_INFO("Recording the trajectories to {}", path);
+  world.set<TrajectoryRecorder>({.writer = std::move(writer)});
+}
+
+bool HasFlag(const int argc, char* argv[], const std::string_view flag) {
+  for (int i = 1; i < argc; ++i) {
+    if (argv[i] == flag)
+      return true;
+  }
+  return false;
+}
+
+int main(const int argc, char* argv[]) {
   sf::ContextSettings settings;
   settings.antiAliasingLevel = 4;
 
   auto window =
       sf::RenderWindow(sf::VideoMode({static_cast<unsigned>(SCREEN_WIDTH), static_cast<unsigned>(SCREEN_HEIGHT)}),
                        "CMake SFML Project", sf::Style::None, sf::State::Windowed, settings);
-  window.setFramerateLimit(144);
+
+  // --low-latency: start each frame right before its deadline instead of sleeping after it. Both modes are
+  // paced by the FramePacer: the framerate limit of SFML sleeps inside display(), after the frame is shown,
+  // and that sleep would end up in the measured latency.
+  const bool lowLatency = HasFlag(argc, argv, "--low-latency");
+  FramePacer pacer(FRAMERATE);
+
+  // shared by the physics systems, declared first so it outlives the world
+  JobSystem jobSystem;
 
   // the unique flecs world
   const flecs::world world;
@@ -182,17 +228,18 @@ int main() {
   // --- Define Singletons ---
   world.set<ScreenBoundaries>({sf::FloatRect{{SCREEN_PADDING, SCREEN_PADDING},
                                              {SCREEN_WIDTH - 2 * SCREEN_PADDING, SCREEN_HEIGHT - 2 * SCREEN_PADDING}}});
+  world.set<Restitution>({RESTITUTION});
+  world.set<PhysicsSettings>({.jobSystem = &jobSystem});
+  world.set<SpatialReorder>({});
+  world.set<SpatialIndex>({std::make_shared<SpatialHashGrid>()});
+
+  // --record <path> [--quantize]
+  StartRecording(world, argc, argv);
 
   // --- Add Entities ---
   CreateScreenBorder(world);
   CreateParticleEntity(world);
 
-  // --- Add Systems ---
-
-  world.system<const CircleRenderable, Transform, RigidBody>("ScreenBounceSystem")
-      .kind(flecs::PostUpdate)
-      .each(HandleBoundaryCollision());
-
   // --- Rendering Systems ---
   world.system<const VerticesRenderable>("VerticesRenderingSystem").kind(flecs::OnStore).each(DrawVertices(window));
   world.system<CircleRenderable, const Transform>("CircleRenderingSystem")
@@ -204,11 +251,22 @@ int main() {
   world.system<const LifeTimeOneFrame>("LifeTimeOneFrameSystem").each(ProcessLifeTimeOneFrame());
 
   // --- Run the game loop ---
+  // Time from polling an event to the display of the frame showing its result. SFML events carry no
+  // timestamp, so the time spent in the OS queue before the poll is not included.
+  LatencyHistogram inputLatency;
+  std::vector<std::chrono::steady_clock::time_point> polledEvents;
+
   sf::Clock clock;
   while (window.isOpen()) {
+    if (lowLatency)
+      pacer.WaitForFrameStart();
+
     const float elapsed = clock.restart().asSeconds();
 
+    polledEvents.clear();
     while (const std::optional event = window.pollEvent()) {
+      polledEvents.push_back(std::chrono::steady_clock::now());
+
       if (event->is<sf::Event::Closed>()) {
         window.close();
       } else if (const auto* keyPressed = event->getIf<sf::Event::KeyPressed>()) {
@@ -224,9 +282,16 @@ int main() {
       } else if (const auto* mouseMoved = event->getIf<sf::Event::MouseMoved>()) {
         UpdateThrowLine(world, mouseMoved);
       } else if (const auto* mousePressed = event->getIf<sf::Event::MouseButtonPressed>()) {
-        // Record the position of the initial click
-        world.set<MouseState>({.startPosition = mousePressed->position});
+        if (mousePressed->button == sf::Mouse::Button::Right) {
+          HighlightParticleUnderMouse(world, mousePressed);
+        } else {
+          // Record the position of the initial click
+          world.set<MouseState>({.startPosition = mousePressed->position});
+        }
       } else if (auto* mouseReleased = event->getIf<sf::Event::MouseButtonReleased>()) {
+        if (!world.has<MouseState>())
+          continue;
+
         ShotParticleOnMouseReleased(world, mouseReleased);
         world.remove<VerticesRenderable>();
       }
@@ -235,7 +300,21 @@ int main() {
     window.clear(NordTheme::PolarNight4);
     world.progress(elapsed);
     window.display();
+
+    const auto displayed = std::chrono::steady_clock::now();
+    for (const auto& polled : polledEvents) {
+      inputLatency.Record(displayed - polled);
+    }
+
+    if (lowLatency)
+      pacer.EndFrame();
+    else
+      pacer.WaitForFrameEnd();
   }
 
+  const auto& reorder = world.get<SpatialReorder>();
+  LOG_INFO("Morton sort ran {} times for {:.3f} ms in total", reorder.sortCount, reorder.totalSortMilliseconds);
+  LOG_INFO("Input latency ({} pacing): {}", lowLatency ? "low-latency" : "framerate limit", inputLatency.ToString());
+
   return 0;
 }
@@ -3,15 +3,27 @@
 #include "PhysicsModule/PhysicsModule.h"
 
 #include "PhysicsModule/Components/Acceleration.h"
+#include "PhysicsModule/Components/CircleCollider.h"
 #include "PhysicsModule/Components/Damping.h"
 #include "PhysicsModule/Components/Drag.h"
 #include "PhysicsModule/Components/Gravity.h"
+#include "PhysicsModule/Components/IntegrationStats.h"
+#include "PhysicsModule/Components/PhysicsSettings.h"
+#include "PhysicsModule/Components/Restitution.h"
 #include "PhysicsModule/Components/RigidBody.h"
+#include "PhysicsModule/Components/SpatialIndex.h"
+#include "PhysicsModule/Components/SpatialReorder.h"
+#include "PhysicsModule/Components/TrajectoryRecorder.h"
 #include "PhysicsModule/Systems/IntegrateAcceleration.h"
 #include "PhysicsModule/Systems/IntegrateDamping.h"
 #include "PhysicsModule/Systems/IntegrateDrag.h"
 #include "PhysicsModule/Systems/IntegrateGravity.h"
 #include "PhysicsModule/Systems/IntegratePhysics.h"
+#include "PhysicsModule/Systems/RecordTrajectory.h"
+#include "PhysicsModule/Systems/ResolveBoundaryCollision.h"
+#include "PhysicsModule/Systems/ResolveContacts.h"
+#include "PhysicsModule/Systems/SortByMortonCode.h"
+#include "PhysicsModule/Systems/UpdateSpatialIndex.h"
 
 void PhysicsModule::Register(const flecs::world& world) {
   world.component<RigidBody>();
@@ -19,8 +31,18 @@ void PhysicsModule::Register(const flecs::world& world) {
   world.component<Gravity>();
   world.component<Damping>();
   world.component<Acceleration>();
+  world.component<Restitution>();
+  world.component<CircleCollider>();
+  world.component<PhysicsSettings>();
+  world.component<TrajectoryRecorder>();
+  world.component<SpatialReorder>();
+  world.component<IntegrationStats>();
+  world.component<SpatialIndex>();
 
   // --- Register Systems ---
+  // Only sorts when a SpatialReorder singleton is set
+  SortByMortonCode::Register(world);
+
   IntegrateGravity::Register(world);
   IntegrateAcceleration::Register(world);
   IntegrateDrag::Register(world);
@@ -28,4 +50,16 @@ void PhysicsModule::Register(const flecs::world& world) {
   
   // Integrate the accumulated forces
   IntegratePhysics::Register(world);
+
+  // Push overlapping bodies apart
+  ResolveContacts::Register(world);
+
+  // Keep the bodies inside the screen boundaries
+  ResolveBoundaryCollision::Register(world);
+
+  // Only indexes when a SpatialIndex singleton is set
+  UpdateSpatialIndex::Register(world);
+
+  // Only records when a TrajectoryRecorder singleton is set
+  RecordTrajectory::Register(world);
 }
@@ -0,0 +1,329 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#include "PhysicsModule/Spatial/SpatialHashGrid.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Keeps the cell coordinates far from the int limits, positions past this are clamped to the border cells
+constexpr float MAX_CELL_COORDINATE = 1 << 30;
+
+std::optional<RaycastHit> IntersectCircle(const sf::Vector2f origin, const sf::Vector2f direction,
+                                          const float maxDistance, const flecs::entity_t entity,
+                                          const sf::Vector2f center, const float radius) {
+  const sf::Vector2f m = origin - center;
+  const float b = m.dot(direction);
+  const float c = m.lengthSquared() - radius * radius;
+
+  // Origin outside of the circle and pointing away from it
+  if (c > 0.f && b > 0.f)
+    return std::nullopt;
+
+  const float discriminant = b * b - c;
+  if (discriminant < 0.f)
+    return std::nullopt;
+
+  // A ray starting inside the circle hits it right away
+  const float distance = std::max(-b - std::sqrt(discriminant), 0.f);
+  if (distance > maxDistance)
+    return std::nullopt;
+
+  const sf::Vector2f point = origin + direction * distance;
+  const sf::Vector2f offset = point - center;
+  const sf::Vector2f normal = offset.lengthSquared() > 0.f ? offset.normalized() : -direction;
+  return RaycastHit{.entity = entity, .distance = distance, .point = point, .normal = normal};
+}
+
+// Closest hit first, the entity id breaks the ties so the result does not depend on the storage order
+bool IsCloser(const RaycastHit& a, const RaycastHit& b) {
+  return a.distance < b.distance || (a.distance == b.distance && a.entity < b.entity);
+}
+
+}  // namespace
+
+SpatialHashGrid::SpatialHashGrid(const float cellSize) : cellSize(cellSize), inverseCellSize(1.f / cellSize) {
+  assert(cellSize > 0.f);
+}
+
+template <typename Fn>
+void SpatialHashGrid::ForEachInCells(const CellCoordinates min, const CellCoordinates max, Fn&& fn) const {
+  // A huge region is cheaper to answer by walking the occupied cells
+  const std::int64_t regionCells = (static_cast<std::int64_t>(max.x) - min.x + 1) *
+                                   (static_cast<std::int64_t>(max.y) - min.y + 1);
+  if (regionCells > static_cast<std::int64_t>(cells.size())) {
+    for (const auto& [key, entries] : cells) {
+      const auto [x, y] = GetCellCoordinates(key);
+      if (x < min.x || x > max.x || y < min.y || y > max.y)
+        continue;
+
+      for (const Entry& entry : entries) {
+        fn(entry);
+      }
+    }
+    return;
+  }
+
+  for (int y = min.y; y <= max.y; ++y) {
+    for (int x = min.x; x <= max.x; ++x) {
+      const auto found = cells.find(GetCellKey({x, y}));
+      if (found == cells.end())
+        continue;
+
+      for (const Entry& entry : found->second) {
+        fn(entry);
+      }
+    }
+  }
+}
+
+template <typename OnEntry, typename ShouldStop>
+void SpatialHashGrid::TraverseRay(const sf::Vector2f origin, const sf::Vector2f direction, const float maxDistance,
+                                  OnEntry&& onEntry, ShouldStop&& shouldStop) const {
+  if (!std::isfinite(maxDistance) || maxDistance < 0.f || !std::isfinite(origin.x) || !std::isfinite(origin.y) ||
+      cells.empty())
+    return;
+
+  // A circle crossing the ray at some distance has its center at most `reach` cells away from the ray cell
+  const int reach = static_cast<int>(std::ceil(maxRadius * inverseCellSize));
+
+  // Clip the ray to the occupied cells grown by the largest radius, nothing can be hit outside of them.
+  // Distances are kept in double: summing float steps stalls on long rays and the walk would never end.
+  const double size = cellSize;
+  const double originX = origin.x;
+  const double originY = origin.y;
+  double enter = 0.;
+  double exit = maxDistance;
+  const auto clip = [&](const double start, const double dir, const double min, const double max) {
+    if (dir == 0.) {
+      if (start < min || start > max)
+        exit = -1.;
+      return;
+    }
+    const double t1 = (min - start) / dir;
+    const double t2 = (max - start) / dir;
+    enter = std::max(enter, std::min(t1, t2));
+    exit = std::min(exit, std::max(t1, t2));
+  };
+  clip(originX, direction.x, occupiedColumns.begin()->first * size - maxRadius,
+       (occupiedColumns.rbegin()->first + 1) * size + maxRadius);
+  clip(originY, direction.y, occupiedRows.begin()->first * size - maxRadius,
+       (occupiedRows.rbegin()->first + 1) * size + maxRadius);
+  if (enter > exit)
+    return;
+
+  // Amanatides & Woo grid traversal, starting where the ray enters the occupied cells
+  const auto toCell = [size](const double value) {
+    return static_cast<int>(std::clamp(std::floor(value / size), static_cast<double>(-MAX_CELL_COORDINATE),
+                                       static_cast<double>(MAX_CELL_COORDINATE)));
+  };
+  CellCoordinates cell = {toCell(originX + direction.x * enter), toCell(originY + direction.y * enter)};
+  const int stepX = direction.x > 0.f ? 1 : (direction.x < 0.f ? -1 : 0);
+  const int stepY = direction.y > 0.f ? 1 : (direction.y < 0.f ? -1 : 0);
+
+  // Distance along the ray to the next border, computed from the cell index so no error accumulates
+  const auto nextBorder = [size](const int index, const int step, const double start, const double dir) {
+    if (step == 0)
+      return std::numeric_limits<double>::infinity();
+    return ((index + (step > 0 ? 1 : 0)) * size - start) / dir;
+  };
+
+  // The ray never turns back, so moving to the next cell only exposes one new column or row of the window
+  // around it and each cell is visited once without remembering the previous ones
+  ForEachInCells({cell.x - reach, cell.y - reach}, {cell.x + reach, cell.y + reach}, onEntry);
+
+  while (true) {
+    // Everything crossing the ray before it leaves this cell has been tested
+    const double nextX = nextBorder(cell.x, stepX, originX, direction.x);
+    const double nextY = nextBorder(cell.y, stepY, originY, direction.y);
+    const double traveled = std::min(nextX, nextY);
+    if (traveled > exit || shouldStop(static_cast<float>(traveled)))
+      return;
+
+    if (nextX < nextY) {
+      cell.x += stepX;
+      const int column = cell.x + stepX * reach;
+      ForEachInCells({column, cell.y - reach}, {column, cell.y + reach}, onEntry);
+    } else {
+      cell.y += stepY;
+      const int row = cell.y + stepY * reach;
+      ForEachInCells({cell.x - reach, row}, {cell.x + reach, row}, onEntry);
+    }
+  }
+}
+
+void SpatialHashGrid::Update(const flecs::entity_t entity, const sf::Vector2f position, const float radius) {
+  maxRadius = std::max(maxRadius, radius);
+  const std::int64_t cell = GetCellKey(GetCellCoordinates(position));
+
+  const auto found = locations.find(entity);
+  if (found != locations.end()) {
+    Location& location = found->second;
+
+    // Most bodies stay in their cell, only refresh the entry
+    if (location.cell == cell) {
+      cells[cell][location.slot] = {entity, position, radius};
+      return;
+    }
+
+    RemoveFromCell(location);
+    const auto [entries, created] = cells.try_emplace(cell);
+    if (created)
+      AddOccupiedCell(cell);
+    location = {cell, static_cast<std::uint32_t>(entries->second.size())};
+    entries->second.push_back({entity, position, radius});
+    return;
+  }
+
+  const auto [entries, created] = cells.try_emplace(cell);
+  if (created)
+    AddOccupiedCell(cell);
+  locations.emplace(entity, Location{cell, static_cast<std::uint32_t>(entries->second.size())});
+  entries->second.push_back({entity, position, radius});
+}
+
+void SpatialHashGrid::Remove(const flecs::entity_t entity) {
+  const auto found = locations.find(entity);
+  if (found == locations.end())
+    return;
+
+  RemoveFromCell(found->second);
+  locations.erase(found);
+}
+
+void SpatialHashGrid::RemoveFromCell(const Location& location) {
+  const auto cell = cells.find(location.cell);
+  assert(cell != cells.end());
+  auto& entries = cell->second;
+
+  // Swap with the last entry and fix the slot of the one that moved
+  if (location.slot + 1 != entries.size()) {
+    entries[location.slot] = entries.back();
+    locations[entries[location.slot].entity].slot = location.slot;
+  }
+  entries.pop_back();
+
+  if (entries.empty()) {
+    cells.erase(cell);
+    RemoveOccupiedCell(location.cell);
+  }
+}
+
+void SpatialHashGrid::AddOccupiedCell(const std::int64_t key) {
+  const auto [x, y] = GetCellCoordinates(key);
+  ++occupiedColumns[x];
+  ++occupiedRows[y];
+}
+
+void SpatialHashGrid::RemoveOccupiedCell(const std::int64_t key) {
+  const auto [x, y] = GetCellCoordinates(key);
+  if (--occupiedColumns[x] == 0)
+    occupiedColumns.erase(x);
+  if (--occupiedRows[y] == 0)
+    occupiedRows.erase(y);
+}
+
+std::optional<flecs::entity_t> SpatialHashGrid::PointPick(const sf::Vector2f point) const {
+  const sf::Vector2f reach = {maxRadius, maxRadius};
+  std::optional<flecs::entity_t> picked;
+  float pickedDistance = std::numeric_limits<float>::max();
+
+  ForEachInCells(GetCellCoordinates(point - reach), GetCellCoordinates(point + reach), [&](const Entry& entry) {
+    const float distance = (entry.position - point).lengthSquared();
+    if (distance > entry.radius * entry.radius)
+      return;
+
+    if (!picked || distance < pickedDistance || (distance == pickedDistance && entry.entity < *picked)) {
+      picked = entry.entity;
+      pickedDistance = distance;
+    }
+  });
+
+  return picked;
+}
+
+void SpatialHashGrid::OverlapCircle(const sf::Vector2f center, const float radius,
+                                    std::vector<flecs::entity_t>& out) const {
+  const sf::Vector2f reach = {radius + maxRadius, radius + maxRadius};
+
+  ForEachInCells(GetCellCoordinates(center - reach), GetCellCoordinates(center + reach), [&](const Entry& entry) {
+    const float radii = radius + entry.radius;
+    if ((entry.position - center).lengthSquared() <= radii * radii)
+      out.push_back(entry.entity);
+  });
+}
+
+void SpatialHashGrid::OverlapRect(const sf::FloatRect& rect, std::vector<flecs::entity_t>& out) const {
+  const sf::Vector2f min = rect.position;
+  const sf::Vector2f max = rect.position + rect.size;
+  const sf::Vector2f reach = {maxRadius, maxRadius};
+
+  ForEachInCells(GetCellCoordinates(min - reach), GetCellCoordinates(max + reach), [&](const Entry& entry) {
+    const sf::Vector2f closest = {std::clamp(entry.position.x, min.x, max.x),
+                                  std::clamp(entry.position.y, min.y, max.y)};
+    if ((entry.position - closest).lengthSquared() <= entry.radius * entry.radius)
+      out.push_back(entry.entity);
+  });
+}
+
+std::optional<RaycastHit> SpatialHashGrid::Raycast(const sf::Vector2f origin, const sf::Vector2f direction,
+                                                   const float maxDistance) const {
+  if (direction.lengthSquared() <= 0.f)
+    return std::nullopt;
+
+  const sf::Vector2f normalized = direction.normalized();
+  std::optional<RaycastHit> closest;
+
+  TraverseRay(
+      origin, normalized, maxDistance,
+      [&](const Entry& entry) {
+        const auto hit = IntersectCircle(origin, normalized, maxDistance, entry.entity, entry.position, entry.radius);
+        if (hit && (!closest || IsCloser(*hit, *closest)))
+          closest = hit;
+      },
+      [&](const float traveled) { return closest && closest->distance <= traveled; });
+
+  return closest;
+}
+
+void SpatialHashGrid::RaycastAll(const sf::Vector2f origin, const sf::Vector2f direction, const float maxDistance,
+                                 std::vector<RaycastHit>& out) const {
+  if (direction.lengthSquared() <= 0.f)
+    return;
+
+  const sf::Vector2f normalized = direction.normalized();
+  const std::size_t first = out.size();
+
+  TraverseRay(
+      origin, normalized, maxDistance,
+      [&](const Entry& entry) {
+        if (const auto hit =
+                IntersectCircle(origin, normalized, maxDistance, entry.entity, entry.position, entry.radius))
+          out.push_back(*hit);
+      },
+      [](float) { return false; });
+
+  std::sort(out.begin() + static_cast<std::ptrdiff_t>(first), out.end(), IsCloser);
+}
+
+SpatialHashGrid::CellCoordinates SpatialHashGrid::GetCellCoordinates(const sf::Vector2f position) const {
+  const auto toCell = [this](const float value) {
+    const float cell = std::floor(value * inverseCellSize);
+    if (std::isnan(cell))
+      return 0;
+    return static_cast<int>(std::clamp(cell, -MAX_CELL_COORDINATE, MAX_CELL_COORDINATE));
+  };
+
+  return {toCell(position.x), toCell(position.y)};
+}
+
+std::int64_t SpatialHashGrid::GetCellKey(const CellCoordinates coordinates) {
+  return (static_cast<std::int64_t>(coordinates.x) << 32) | static_cast<std::uint32_t>(coordinates.y);
+}
+
+SpatialHashGrid::CellCoordinates SpatialHashGrid::GetCellCoordinates(const std::int64_t key) {
+  return {static_cast<int>(key >> 32), static_cast<int>(static_cast<std::uint32_t>(key))};
+}
@@ -0,0 +1,81 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#include "PhysicsModule/Spatial/SpatialQuery.h"
+
+#include <cassert>
+
+#include "Core/Utilities/JobSystem.h"
+#include "PhysicsModule/Components/PhysicsSettings.h"
+#include "PhysicsModule/Components/SpatialIndex.h"
+
+namespace {
+
+// Queries are cheap, hand them out to the workers in large chunks
+constexpr std::size_t BATCH_GRAIN = 256;
+
+const SpatialHashGrid* GetGrid(const flecs::world& world) {
+  const auto* index = world.try_get<SpatialIndex>();
+  return index ? index->grid.get() : nullptr;
+}
+
+template <typename Fn>
+void ForEachInBatch(const flecs::world& world, const std::size_t count, Fn&& fn) {
+  const auto* settings = world.try_get<PhysicsSettings>();
+  if (settings && settings->jobSystem) {
+    settings->jobSystem->ParallelFor(count, fn, BATCH_GRAIN);
+    return;
+  }
+
+  for (std::size_t i = 0; i < count; ++i) {
+    fn(i);
+  }
+}
+
+}  // namespace
+
+std::optional<flecs::entity_t> SpatialQuery::PointPick(const flecs::world& world, const sf::Vector2f point) {
+  const auto* grid = GetGrid(world);
+  return grid ? grid->PointPick(point) : std::nullopt;
+}
+
+void SpatialQuery::OverlapCircle(const flecs::world& world, const sf::Vector2f center, const float radius,
+                                 std::vector<flecs::entity_t>& out) {
+  if (const auto* grid = GetGrid(world))
+    grid->OverlapCircle(center, radius, out);
+}
+
+void SpatialQuery::OverlapRect(const flecs::world& world, const sf::FloatRect& rect,
+                               std::vector<flecs::entity_t>& out) {
+  if (const auto* grid = GetGrid(world))
+    grid->OverlapRect(rect, out);
+}
+
+std::optional<RaycastHit> SpatialQuery::Raycast(const flecs::world& world, const Ray& ray) {
+  const auto* grid = GetGrid(world);
+  return grid ? grid->Raycast(ray.origin, ray.direction, ray.maxDistance) : std::nullopt;
+}
+
+void SpatialQuery::RaycastAll(const flecs::world& world, const Ray& ray, std::vector<RaycastHit>& out) {
+  if (const auto* grid = GetGrid(world))
+    grid->RaycastAll(ray.origin, ray.direction, ray.maxDistance, out);
+}
+
+void SpatialQuery::PointPickBatch(const flecs::world& world, const std::span<const sf::Vector2f> points,
+                                  const std::span<std::optional<flecs::entity_t>> picked) {
+  assert(picked.size() >= points.size());
+  const auto* grid = GetGrid(world);
+
+  ForEachInBatch(world, points.size(), [&](const std::size_t i) {
+    picked[i] = grid ? grid->PointPick(points[i]) : std::nullopt;
+  });
+}
+
+void SpatialQuery::RaycastBatch(const flecs::world& world, const std::span<const Ray> rays,
+                                const std::span<std::optional<RaycastHit>> hits) {
+  assert(hits.size() >= rays.size());
+  const auto* grid = GetGrid(world);
+
+  ForEachInBatch(world, rays.size(), [&](const std::size_t i) {
+    hits[i] = grid ? grid->Raycast(rays[i].origin, rays[i].direction, rays[i].maxDistance) : std::nullopt;
+  });
+}
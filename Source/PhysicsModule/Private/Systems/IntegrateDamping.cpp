@@ -12,7 +12,7 @@ auto Update() {
     if (b.inverseMass <= 0.f)
       return;
 
-    b.force += -d.coefficient * b.velocity;
+    b.force += d.GetForce(b.velocity);
   };
 }
 
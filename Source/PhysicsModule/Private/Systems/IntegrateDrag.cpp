@@ -12,15 +12,7 @@ auto Update() {
     if (b.inverseMass <= 0.f)
       return;
 
-    const float speed = b.velocity.length();
-    if (speed <= 0.f)
-      return;
-
-    const float drag = d.k1 * speed + d.k2 * speed * speed;
-    if (drag <= 0.f)
-      return;
-    
-    b.force += -drag * b.velocity.normalized();
+    b.force += d.GetForce(b.velocity);
   };
 }
 
@@ -2,34 +2,165 @@
 
 #include "PhysicsModule/Systems/IntegratePhysics.h"
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "Core/Components/CircleRenderable.h"
+#include "Core/Components/ScreenBoundaries.h"
 #include "Core/Components/Transform.h"
+#include "PhysicsModule/Components/Damping.h"
+#include "PhysicsModule/Components/Drag.h"
+#include "PhysicsModule/Components/IntegrationStats.h"
+#include "PhysicsModule/Components/PhysicsSettings.h"
+#include "PhysicsModule/Components/Restitution.h"
 #include "PhysicsModule/Components/RigidBody.h"
+#include "PhysicsModule/Systems/ResolveBoundaryCollision.h"
 
 namespace {
 
-auto Update() {
-  return [](const flecs::iter& it, size_t, Transform& t, RigidBody& p) {
-    if (p.inverseMass <= 0.f) {
-      p.force = {0.f, 0.f};
-      return;
-    }
+struct Body {
+  Transform* transform;
+  RigidBody* rigidBody;
 
-    const float dt = it.delta_time();
-    assert(dt > 0.f);
+  // optional, re-evaluated at every substep
+  const Damping* damping;
+  const Drag* drag;
+  const CircleRenderable* circle;
+};
+
+sf::Vector2f GetVelocityForce(const Body& body, const sf::Vector2f velocity) {
+  sf::Vector2f force;
+  if (body.damping)
+    force += body.damping->GetForce(velocity);
+  if (body.drag)
+    force += body.drag->GetForce(velocity);
+  return force;
+}
+
+struct Boundary {
+  sf::FloatRect bounds;
+  float restitution;
+};
+
+void Integrate(const Body& body, const int count, const float h, const std::optional<Boundary>& boundary) {
+  Transform& t = *body.transform;
+  RigidBody& p = *body.rigidBody;
+
+  // The accumulated force holds the velocity dependent part evaluated at the start of the step, split it out
+  // so that damping and drag follow the velocity from one substep to the next
+  const sf::Vector2f constantForce = count > 1 ? p.force - GetVelocityForce(body, p.velocity) : p.force;
+
+  for (int substep = 0; substep < count; ++substep) {
+    const sf::Vector2f force = substep == 0 ? p.force : constantForce + GetVelocityForce(body, p.velocity);
 
     // integrate to the velocity considering the damping
-    p.velocity += p.force * p.inverseMass * dt;
+    p.velocity += force * p.inverseMass * h;
 
     // integrate to the position
-    t.position += p.velocity * dt;
+    t.position += p.velocity * h;
+
+    // Bounce between the substeps, the boundary system handles the end of the step after the contacts
+    if (boundary && body.circle && substep + 1 < count)
+      ResolveBoundaryCollision::Resolve(boundary->bounds, body.circle->shape.getRadius(), boundary->restitution, t, p);
+  }
+
+  // reset forces
+  p.force = {0.f, 0.f};
+}
+
+// Bodies grouped by time step bin, kept between steps to reuse the allocations
+using Bins = std::array<std::vector<Body>, IntegrationStats::MAX_BINS>;
+
+// Finest bin needed so that the body moves less than maxDisplacement per substep
+int SelectBin(const RigidBody& p, const float dt, const float maxDisplacement, const int maxBin) {
+  const float speed = p.velocity.length();
+  const float acceleration = (p.force * p.inverseMass).length();
+
+  int bin = 0;
+  float h = dt;
+  while (bin < maxBin && speed * h + acceleration * h * h > maxDisplacement) {
+    ++bin;
+    h *= .5f;
+  }
+  return bin;
+}
 
-    // reset forces
-    p.force = {0.f, 0.f};
+auto Update(std::shared_ptr<Bins> bins) {
+  return [bins](flecs::iter& it) {
+    const auto world = it.world();
+    const float dt = it.delta_time();
+    assert(dt > 0.f);
+
+    const auto* settings = world.try_get<PhysicsSettings>();
+    const PhysicsSettings defaults;
+    const PhysicsSettings& config = settings ? *settings : defaults;
+    const int maxBin = std::clamp(config.maxTimeStepBin, 0, IntegrationStats::MAX_BINS - 1);
+    const float maxDisplacement = config.maxSubstepDisplacement;
+
+    for (auto& bin : *bins) {
+      bin.clear();
+    }
+
+    std::optional<Boundary> boundary;
+    if (const auto* screen = world.try_get<ScreenBoundaries>()) {
+      const auto* restitution = world.try_get<Restitution>();
+      boundary = Boundary{screen->bounds, restitution ? restitution->coefficient : Restitution{}.coefficient};
+    }
+
+    while (it.next()) {
+      auto transforms = it.field<Transform>(0);
+      auto rigidBodies = it.field<RigidBody>(1);
+      const bool hasDamping = it.is_set(2);
+      const bool hasDrag = it.is_set(3);
+      const bool hasCircle = it.is_set(4);
+      for (const auto i : it) {
+        RigidBody& p = rigidBodies[i];
+        if (p.inverseMass <= 0.f) {
+          p.force = {0.f, 0.f};
+          continue;
+        }
+
+        const Body body = {.transform = &transforms[i],
+                           .rigidBody = &p,
+                           .damping = hasDamping ? &it.field<const Damping>(2)[i] : nullptr,
+                           .drag = hasDrag ? &it.field<const Drag>(3)[i] : nullptr,
+                           .circle = hasCircle ? &it.field<const CircleRenderable>(4)[i] : nullptr};
+        (*bins)[SelectBin(p, dt, maxDisplacement, maxBin)].push_back(body);
+      }
+    }
+
+    // Each bin runs at its own rate and every bin ends exactly at dt, the coarse step boundary. Damping, drag
+    // and the boundary response are evaluated at every substep, the other forces are held over the step.
+    std::uint64_t substeps = 0;
+    for (int bin = 0; bin <= maxBin; ++bin) {
+      const int count = 1 << bin;
+      const float h = dt / static_cast<float>(count);
+
+      for (const Body& body : (*bins)[bin]) {
+        Integrate(body, count, h, boundary);
+      }
+
+      substeps += static_cast<std::uint64_t>(count) * (*bins)[bin].size();
+    }
+
+    if (auto* stats = world.try_get_mut<IntegrationStats>()) {
+      for (int bin = 0; bin < IntegrationStats::MAX_BINS; ++bin) {
+        stats->bodiesPerBin[bin] = static_cast<std::uint32_t>((*bins)[bin].size());
+      }
+      stats->substeps = substeps;
+      stats->totalSubsteps += substeps;
+    }
   };
 }
 
 }  // namespace
 
 void IntegratePhysics::Register(const flecs::world& world) {
-  world.system<Transform, RigidBody>("PhysicsIntegratorSystem").kind(flecs::PostUpdate).each(Update());
+  world.system<Transform, RigidBody, const Damping*, const Drag*, const CircleRenderable*>("PhysicsIntegratorSystem")
+      .kind(flecs::PostUpdate)
+      .run(Update(std::make_shared<Bins>()));
 }
@@ -0,0 +1,55 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#include "PhysicsModule/Systems/RecordTrajectory.h"
+
+#include "Core/Components/Transform.h"
+#include "PhysicsModule/Components/RigidBody.h"
+#include "PhysicsModule/Components/TrajectoryRecorder.h"
+#include "Trajectory/TrajectoryWriter.h"
+
+namespace {
+
+auto Update() {
+  return [](flecs::iter& it) {
+    auto* recorder = it.world().try_get_mut<TrajectoryRecorder>();
+    if (!recorder || !recorder->writer) {
+      it.fini();
+      return;
+    }
+
+    recorder->time += it.delta_time();
+
+    // Only copy the columns here, the encoding and the I/O happen on the writer thread
+    TrajectoryFrame frame = recorder->writer->AcquireFrame();
+    frame.step = recorder->step++;
+    frame.time = recorder->time;
+    frame.entities.clear();
+    for (auto& column : frame.columns) {
+      column.clear();
+    }
+
+    while (it.next()) {
+      auto transforms = it.field<const Transform>(0);
+      auto rigidBodies = it.field<const RigidBody>(1);
+      const std::size_t offset = frame.entities.size();
+      frame.Resize(offset + it.count());
+
+      for (const auto i : it) {
+        frame.entities[offset + i] = it.entity(i).id();
+        frame.columns[static_cast<std::size_t>(TrajectoryColumn::PositionX)][offset + i] = transforms[i].position.x;
+        frame.columns[static_cast<std::size_t>(TrajectoryColumn::PositionY)][offset + i] = transforms[i].position.y;
+        frame.columns[static_cast<std::size_t>(TrajectoryColumn::VelocityX)][offset + i] = rigidBodies[i].velocity.x;
+        frame.columns[static_cast<std::size_t>(TrajectoryColumn::VelocityY)][offset + i] = rigidBodies[i].velocity.y;
+      }
+    }
+
+    recorder->writer->Submit(std::move(frame));
+  };
+}
+
+}  // namespace
+
+void RecordTrajectory::Register(const flecs::world& world) {
+  // PreStore: the physics of the step is done, the rendering has not started yet
+  world.system<const Transform, const RigidBody>("RecordTrajectorySystem").kind(flecs::PreStore).run(Update());
+}
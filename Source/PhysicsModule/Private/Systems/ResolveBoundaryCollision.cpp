@@ -0,0 +1,49 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#include "PhysicsModule/Systems/ResolveBoundaryCollision.h"
+
+#include <algorithm>
+
+#include "Core/Components/CircleRenderable.h"
+#include "Core/Components/ScreenBoundaries.h"
+#include "Core/Components/Transform.h"
+#include "PhysicsModule/Components/Restitution.h"
+#include "PhysicsModule/Components/RigidBody.h"
+
+namespace {
+
+auto Update() {
+  return [](const flecs::iter& it, size_t, const CircleRenderable& c, Transform& t, RigidBody& p) {
+    const auto screenBounds = it.world().get<ScreenBoundaries>().bounds;
+    const auto* restitution = it.world().try_get<Restitution>();
+    ResolveBoundaryCollision::Resolve(screenBounds, c.shape.getRadius(),
+                                      restitution ? restitution->coefficient : Restitution{}.coefficient, t, p);
+  };
+}
+
+}  // namespace
+
+void ResolveBoundaryCollision::Register(const flecs::world& world) {
+  world.system<const CircleRenderable, Transform, RigidBody>("ScreenBounceSystem")
+      .kind(flecs::PostUpdate)
+      .each(Update());
+}
+
+void ResolveBoundaryCollision::Resolve(const sf::FloatRect& bounds, const float radius, const float restitution,
+                                       Transform& t, RigidBody& p) {
+  bool collided = false;
+
+  if (t.position.x - radius < bounds.position.x || t.position.x + radius > bounds.position.x + bounds.size.x) {
+    collided = true;
+    p.velocity.x *= -1;
+    t.position.x = std::clamp(t.position.x, bounds.position.x + radius, bounds.position.x + bounds.size.x - radius);
+  } else if (t.position.y - radius < bounds.position.y || t.position.y + radius > bounds.position.y + bounds.size.y) {
+    collided = true;
+    p.velocity.y *= -1;
+    t.position.y = std::clamp(t.position.y, bounds.position.y + radius, bounds.position.y + bounds.size.y - radius);
+  }
+
+  // Restitution
+  if (collided)
+    p.velocity *= restitution;
+}
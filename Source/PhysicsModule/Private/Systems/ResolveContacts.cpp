@@ -0,0 +1,236 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#include "PhysicsModule/Systems/ResolveContacts.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "Core/Components/Transform.h"
+#include "Core/Utilities/JobSystem.h"
+#include "PhysicsModule/Components/CircleCollider.h"
+#include "PhysicsModule/Components/PhysicsSettings.h"
+#include "PhysicsModule/Components/Restitution.h"
+#include "PhysicsModule/Components/RigidBody.h"
+
+namespace {
+
+// Upper bound of the grid size, the cells grow when the bodies are spread too far apart
+constexpr std::size_t MAX_CELLS = 1 << 22;
+
+// Tiles of the same color are at least 3 tiles apart. A tile writes to its own bodies and to the bodies of
+// its direct neighbors, so tiles sharing a color never touch the same body and can be solved concurrently.
+constexpr int COLOR_STRIDE = 3;
+
+struct Body {
+  Transform* transform;
+  RigidBody* rigidBody;
+  float radius;
+};
+
+/**
+ * Uniform grid rebuilt every step, with the bodies sorted by cell. Bodies are gathered in query order and
+ * the counting sort is stable, so the layout only depends on the world state and never on the thread count.
+ */
+struct ContactGrid {
+  std::vector<Body> bodies;
+  std::vector<std::uint32_t> bodyCell;
+  std::vector<std::uint32_t> cellStart;
+  std::vector<std::uint32_t> sorted;
+  std::vector<std::uint32_t> cursor;
+
+  sf::Vector2f origin;
+  float cellSize = 0.f;
+  int columns = 0;
+  int rows = 0;
+
+  bool Build() {
+    if (bodies.size() < 2)
+      return false;
+
+    sf::Vector2f min = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+    sf::Vector2f max = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+    float maxRadius = 0.f;
+    for (const auto& [transform, rigidBody, radius] : bodies) {
+      min.x = std::min(min.x, transform->position.x);
+      min.y = std::min(min.y, transform->position.y);
+      max.x = std::max(max.x, transform->position.x);
+      max.y = std::max(max.y, transform->position.y);
+      maxRadius = std::max(maxRadius, radius);
+    }
+
+    if (maxRadius <= 0.f || !std::isfinite(max.x - min.x) || !std::isfinite(max.y - min.y))
+      return false;
+
+    // Two overlapping bodies are always in the same or in adjacent cells
+    origin = min;
+    cellSize = 2.f * maxRadius;
+    const float cellCount = ((max.x - min.x) / cellSize + 1.f) * ((max.y - min.y) / cellSize + 1.f);
+    if (cellCount > static_cast<float>(MAX_CELLS))
+      cellSize *= std::sqrt(cellCount / static_cast<float>(MAX_CELLS));
+
+    columns = static_cast<int>((max.x - min.x) / cellSize) + 1;
+    rows = static_cast<int>((max.y - min.y) / cellSize) + 1;
+
+    // Counting sort of the bodies by cell
+    cellStart.assign(static_cast<std::size_t>(columns) * rows + 1, 0);
+    bodyCell.resize(bodies.size());
+    for (std::size_t i = 0; i < bodies.size(); ++i) {
+      const auto position = bodies[i].transform->position - origin;
+      const int x = std::min(static_cast<int>(position.x / cellSize), columns - 1);
+      const int y = std::min(static_cast<int>(position.y / cellSize), rows - 1);
+      bodyCell[i] = static_cast<std::uint32_t>(y * columns + x);
+      ++cellStart[bodyCell[i] + 1];
+    }
+
+    for (std::size_t cell = 1; cell < cellStart.size(); ++cell) {
+      cellStart[cell] += cellStart[cell - 1];
+    }
+
+    sorted.resize(bodies.size());
+    cursor.assign(cellStart.begin(), cellStart.end() - 1);
+    for (std::size_t i = 0; i < bodies.size(); ++i) {
+      sorted[cursor[bodyCell[i]]++] = static_cast<std::uint32_t>(i);
+    }
+
+    return true;
+  }
+};
+
+void ResolvePair(Body& a, Body& b, const float restitution) {
+  const float inverseMassSum = a.rigidBody->inverseMass + b.rigidBody->inverseMass;
+  if (inverseMassSum <= 0.f)
+    return;
+
+  const sf::Vector2f delta = b.transform->position - a.transform->position;
+  const float radii = a.radius + b.radius;
+  const float distanceSquared = delta.lengthSquared();
+  if (distanceSquared >= radii * radii)
+    return;
+
+  // Perfectly stacked bodies get pushed apart along x, any fixed axis keeps the result deterministic
+  const float distance = std::sqrt(distanceSquared);
+  const sf::Vector2f normal = distance > 0.f ? delta / distance : sf::Vector2f{1.f, 0.f};
+
+  // Move the bodies out of each other proportionally to their inverse mass
+  const sf::Vector2f correction = normal * ((radii - distance) / inverseMassSum);
+  a.transform->position -= correction * a.rigidBody->inverseMass;
+  b.transform->position += correction * b.rigidBody->inverseMass;
+
+  // Only apply an impulse if they are moving toward each other
+  const float closingVelocity = (b.rigidBody->velocity - a.rigidBody->velocity).dot(normal);
+  if (closingVelocity >= 0.f)
+    return;
+
+  const sf::Vector2f impulse = normal * (-(1.f + restitution) * closingVelocity / inverseMassSum);
+  a.rigidBody->velocity -= impulse * a.rigidBody->inverseMass;
+  b.rigidBody->velocity += impulse * b.rigidBody->inverseMass;
+}
+
+void ResolveTile(ContactGrid& grid, const int tileX, const int tileY, const int tileCells, const float restitution) {
+  // Each pair is visited once: same cell with a later body, or one of the four "forward" neighbor cells
+  constexpr int FORWARD_NEIGHBORS[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+
+  const int beginX = tileX * tileCells;
+  const int beginY = tileY * tileCells;
+  const int endX = std::min(beginX + tileCells, grid.columns);
+  const int endY = std::min(beginY + tileCells, grid.rows);
+
+  for (int y = beginY; y < endY; ++y) {
+    for (int x = beginX; x < endX; ++x) {
+      const std::uint32_t cell = y * grid.columns + x;
+      const std::uint32_t cellEnd = grid.cellStart[cell + 1];
+
+      for (std::uint32_t i = grid.cellStart[cell]; i < cellEnd; ++i) {
+        Body& body = grid.bodies[grid.sorted[i]];
+
+        for (std::uint32_t j = i + 1; j < cellEnd; ++j) {
+          ResolvePair(body, grid.bodies[grid.sorted[j]], restitution);
+        }
+
+        for (const auto& [offsetX, offsetY] : FORWARD_NEIGHBORS) {
+          const int neighborX = x + offsetX;
+          const int neighborY = y + offsetY;
+          if (neighborX < 0 || neighborX >= grid.columns || neighborY >= grid.rows)
+            continue;
+
+          const std::uint32_t neighbor = neighborY * grid.columns + neighborX;
+          for (std::uint32_t j = grid.cellStart[neighbor]; j < grid.cellStart[neighbor + 1]; ++j) {
+            ResolvePair(body, grid.bodies[grid.sorted[j]], restitution);
+          }
+        }
+      }
+    }
+  }
+}
+
+auto Update(std::shared_ptr<ContactGrid> grid) {
+  return [grid](flecs::iter& it) {
+    const auto world = it.world();
+
+    grid->bodies.clear();
+    while (it.next()) {
+      auto transforms = it.field<Transform>(0);
+      auto rigidBodies = it.field<RigidBody>(1);
+      auto colliders = it.field<const CircleCollider>(2);
+      for (const auto i : it) {
+        // A diverged body cannot be binned, leave it out of the contacts instead of corrupting the grid
+        const sf::Vector2f position = transforms[i].position;
+        if (!std::isfinite(position.x) || !std::isfinite(position.y))
+          continue;
+
+        grid->bodies.push_back({&transforms[i], &rigidBodies[i], colliders[i].radius});
+      }
+    }
+
+    if (!grid->Build())
+      return;
+
+    const auto* settings = world.try_get<PhysicsSettings>();
+    const PhysicsSettings defaults;
+    const PhysicsSettings& config = settings ? *settings : defaults;
+    const auto* restitutionSingleton = world.try_get<Restitution>();
+    const float restitution = restitutionSingleton ? restitutionSingleton->coefficient : Restitution{}.coefficient;
+
+    const int tileSize = std::max(config.tileCells, 1);
+    const int tileColumns = (grid->columns + tileSize - 1) / tileSize;
+    const int tileRows = (grid->rows + tileSize - 1) / tileSize;
+
+    for (int iteration = 0; iteration < config.solverIterations; ++iteration) {
+      for (int color = 0; color < COLOR_STRIDE * COLOR_STRIDE; ++color) {
+        const int firstX = color % COLOR_STRIDE;
+        const int firstY = color / COLOR_STRIDE;
+        const int colorColumns = (tileColumns - firstX + COLOR_STRIDE - 1) / COLOR_STRIDE;
+        const int colorRows = (tileRows - firstY + COLOR_STRIDE - 1) / COLOR_STRIDE;
+        if (colorColumns <= 0 || colorRows <= 0)
+          continue;
+
+        const auto solveTile = [&](const std::size_t index) {
+          const int tileX = firstX + static_cast<int>(index % colorColumns) * COLOR_STRIDE;
+          const int tileY = firstY + static_cast<int>(index / colorColumns) * COLOR_STRIDE;
+          ResolveTile(*grid, tileX, tileY, tileSize, restitution);
+        };
+
+        const std::size_t tileCount = static_cast<std::size_t>(colorColumns) * colorRows;
+        if (config.jobSystem) {
+          config.jobSystem->ParallelFor(tileCount, solveTile);
+        } else {
+          for (std::size_t index = 0; index < tileCount; ++index) {
+            solveTile(index);
+          }
+        }
+      }
+    }
+  };
+}
+
+}  // namespace
+
+void ResolveContacts::Register(const flecs::world& world) {
+  world.system<Transform, RigidBody, const CircleCollider>("ResolveContactsSystem")
+      .kind(flecs::PostUpdate)
+      .run(Update(std::make_shared<ContactGrid>()));
+}
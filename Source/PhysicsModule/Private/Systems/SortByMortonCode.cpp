@@ -0,0 +1,111 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#include "PhysicsModule/Systems/SortByMortonCode.h"
+
+#include <chrono>
+#include <cstdint>
+
+#include "Core/Components/Transform.h"
+#include "Core/Utilities/Logger.h"
+#include "Core/Utilities/Morton.h"
+#include "PhysicsModule/Components/RigidBody.h"
+#include "PhysicsModule/Components/SpatialReorder.h"
+
+namespace {
+
+// Bodies within the same cell are ordered by entity id, smaller cells only add churn
+constexpr float MORTON_CELL_SIZE = 8.f;
+
+std::uint64_t GetMortonCode(const Transform& t) {
+  return Morton::Encode(t.position.x, t.position.y, MORTON_CELL_SIZE);
+}
+
+int CompareMortonCode(const flecs::entity_t e1, const Transform* t1, const flecs::entity_t e2, const Transform* t2) {
+  const std::uint64_t c1 = GetMortonCode(*t1);
+  const std::uint64_t c2 = GetMortonCode(*t2);
+  if (c1 != c2)
+    return c1 < c2 ? -1 : 1;
+
+  // the table sort is not stable, the entity id keeps the order deterministic
+  return (e1 > e2) - (e1 < e2);
+}
+
+// Fraction of consecutive bodies in a table that are out of Morton order: 0 when sorted, ~0.5 when random
+float MeasureDisorder(flecs::iter& it) {
+  std::size_t pairs = 0;
+  std::size_t inversions = 0;
+
+  while (it.next()) {
+    if (it.count() < 2)
+      continue;
+
+    auto transforms = it.field<const Transform>(0);
+    std::uint64_t previous = GetMortonCode(transforms[0]);
+    for (std::size_t i = 1; i < it.count(); ++i) {
+      const std::uint64_t current = GetMortonCode(transforms[i]);
+      inversions += current < previous;
+      previous = current;
+    }
+    pairs += it.count() - 1;
+  }
+
+  return pairs > 0 ? static_cast<float>(inversions) / static_cast<float>(pairs) : 0.f;
+}
+
+auto Update(const flecs::query<const Transform>& sortedQuery) {
+  return [sortedQuery](flecs::iter& it) {
+    auto* reorder = it.world().try_get_mut<SpatialReorder>();
+    if (!reorder) {
+      it.fini();
+      return;
+    }
+
+    ++reorder->stepsSinceSort;
+    ++reorder->stepsSinceDisorderCheck;
+    bool disordered = false;
+    if (reorder->disorderThreshold > 0.f && reorder->stepsSinceDisorderCheck >= reorder->disorderCheckInterval) {
+      reorder->disorder = MeasureDisorder(it);
+      reorder->stepsSinceDisorderCheck = 0;
+      disordered = reorder->disorder > reorder->disorderThreshold;
+    } else {
+      it.fini();
+    }
+
+    const bool due = reorder->interval > 0 && reorder->stepsSinceSort >= reorder->interval;
+    if (!due && !disordered)
+      return;
+
+    // Iterating a query with order_by sorts the storage of the matched tables in place
+    const auto start = std::chrono::steady_clock::now();
+    sortedQuery.run([](flecs::iter& sortIt) {
+      while (sortIt.next()) {
+      }
+    });
+    const auto end = std::chrono::steady_clock::now();
+
+    reorder->lastSortMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    reorder->totalSortMilliseconds += reorder->lastSortMilliseconds;
+    ++reorder->sortCount;
+    reorder->stepsSinceSort = 0;
+
+    LOG_DEBUG("Morton sort #{} took {:.3f} ms, disorder was {:.2f}", reorder->sortCount,
+              reorder->lastSortMilliseconds, reorder->disorder);
+  };
+}
+
+}  // namespace
+
+void SortByMortonCode::Register(const flecs::world& world) {
+  const auto sortedQuery = world.query_builder<const Transform>()
+                               .with<RigidBody>()
+                               .order_by<Transform>(CompareMortonCode)
+                               .cached()
+                               .build();
+
+  // Immediate: sorting moves the table storage, it cannot happen while the world is readonly
+  world.system<const Transform>("SortByMortonCodeSystem")
+      .with<RigidBody>()
+      .kind(flecs::PreUpdate)
+      .immediate()
+      .run(Update(sortedQuery));
+}
@@ -0,0 +1,44 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#include "PhysicsModule/Systems/UpdateSpatialIndex.h"
+
+#include "Core/Components/Transform.h"
+#include "PhysicsModule/Components/CircleCollider.h"
+#include "PhysicsModule/Components/SpatialIndex.h"
+#include "PhysicsModule/Spatial/SpatialHashGrid.h"
+
+namespace {
+
+auto Update() {
+  return [](flecs::iter& it) {
+    const auto* index = it.world().try_get<SpatialIndex>();
+    if (!index || !index->grid) {
+      it.fini();
+      return;
+    }
+
+    while (it.next()) {
+      auto transforms = it.field<const Transform>(0);
+      auto colliders = it.field<const CircleCollider>(1);
+      for (const auto i : it) {
+        index->grid->Update(it.entity(i).id(), transforms[i].position, colliders[i].radius);
+      }
+    }
+  };
+}
+
+auto Remove() {
+  return [](const flecs::entity& e, const CircleCollider&) {
+    const auto* index = e.world().try_get<SpatialIndex>();
+    if (index && index->grid)
+      index->grid->Remove(e.id());
+  };
+}
+
+}  // namespace
+
+void UpdateSpatialIndex::Register(const flecs::world& world) {
+  // PreStore: the bodies are at their final position for this step
+  world.system<const Transform, const CircleCollider>("UpdateSpatialIndexSystem").kind(flecs::PreStore).run(Update());
+  world.observer<const CircleCollider>("RemoveFromSpatialIndexObserver").event(flecs::OnRemove).each(Remove());
+}
@@ -0,0 +1,7 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+struct CircleCollider {
+  float radius = 20.f;
+};
@@ -2,6 +2,10 @@
 
 #pragma once
 
+#include <SFML/System/Vector2.hpp>
+
 struct Damping {
   float coefficient = 1.15f;
+
+  [[nodiscard]] sf::Vector2f GetForce(const sf::Vector2f velocity) const { return -coefficient * velocity; }
 };
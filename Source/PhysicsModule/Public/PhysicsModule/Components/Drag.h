@@ -2,7 +2,21 @@
 
 #pragma once
 
+#include <SFML/System/Vector2.hpp>
+
 struct Drag {
   float k1 = .05f;
   float k2 = .001f;
+
+  [[nodiscard]] sf::Vector2f GetForce(const sf::Vector2f velocity) const {
+    const float speed = velocity.length();
+    if (speed <= 0.f)
+      return {0.f, 0.f};
+
+    const float drag = k1 * speed + k2 * speed * speed;
+    if (drag <= 0.f)
+      return {0.f, 0.f};
+
+    return -drag * (velocity / speed);
+  }
 };
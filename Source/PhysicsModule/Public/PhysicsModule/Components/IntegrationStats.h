@@ -0,0 +1,18 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * Optional singleton filled by the integrator with the work of the last step.
+ */
+struct IntegrationStats {
+  static constexpr int MAX_BINS = 16;
+
+  // number of bodies per time step bin
+  std::array<std::uint32_t, MAX_BINS> bodiesPerBin = {};
+  std::uint64_t substeps = 0;
+  std::uint64_t totalSubsteps = 0;
+};
@@ -0,0 +1,26 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+class JobSystem;
+
+/**
+ * Optional singleton tuning the physics systems. Without it, or without a job system,
+ * everything runs on the thread calling progress().
+ */
+struct PhysicsSettings {
+  // not owned, must outlive the world
+  JobSystem* jobSystem = nullptr;
+
+  // Gauss-Seidel passes over all the contacts per step
+  int solverIterations = 2;
+
+  // width of a contact tile in grid cells, a tile is the unit of work handed to the job system
+  int tileCells = 8;
+
+  // bodies in bin b are integrated 2^b times per step, 0 integrates every body once
+  int maxTimeStepBin = 4;
+
+  // a body moves to a finer bin until it travels less than this per substep
+  float maxSubstepDisplacement = 4.f;
+};
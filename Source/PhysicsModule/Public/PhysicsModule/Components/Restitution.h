@@ -0,0 +1,8 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+struct Restitution {
+  // ratio of the velocity kept after a bounce
+  float coefficient = .9f;
+};
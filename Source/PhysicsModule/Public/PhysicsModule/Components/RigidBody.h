@@ -1,3 +1,7 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
 #include <SFML/System/Vector2.hpp>
 
 struct RigidBody {
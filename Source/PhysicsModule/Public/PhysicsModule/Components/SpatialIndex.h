@@ -0,0 +1,15 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+#include <memory>
+
+class SpatialHashGrid;
+
+/**
+ * Singleton enabling the spatial queries, the bodies with a CircleCollider are kept up to date
+ * in the grid at the end of every step.
+ */
+struct SpatialIndex {
+  std::shared_ptr<SpatialHashGrid> grid;
+};
@@ -0,0 +1,27 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Singleton enabling the periodic sort of the rigid body tables along a Morton curve, so bodies
+ * close in space are also close in memory. The second half of the struct holds the metrics.
+ */
+struct SpatialReorder {
+  // sort at least every interval steps, 0 to only sort on disorder
+  int interval = 120;
+
+  // sort early when this fraction of neighbors in a table are out of order, 0 to disable the check
+  float disorderThreshold = .25f;
+
+  // the disorder check walks every body, only run it every few steps
+  int disorderCheckInterval = 10;
+
+  std::uint64_t sortCount = 0;
+  int stepsSinceSort = 0;
+  int stepsSinceDisorderCheck = 0;
+  float disorder = 0.f;
+  double lastSortMilliseconds = 0.;
+  double totalSortMilliseconds = 0.;
+};
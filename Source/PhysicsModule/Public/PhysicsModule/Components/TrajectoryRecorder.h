@@ -0,0 +1,18 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+class TrajectoryWriter;
+
+/**
+ * Singleton enabling the trajectory recording, every step appends the position and velocity
+ * of all the rigid bodies to the writer.
+ */
+struct TrajectoryRecorder {
+  std::shared_ptr<TrajectoryWriter> writer;
+  std::uint64_t step = 0;
+  double time = 0.;
+};
@@ -0,0 +1,101 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+#include <flecs.h>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+struct RaycastHit {
+  flecs::entity_t entity = 0;
+  float distance = 0.f;
+  sf::Vector2f point;
+  sf::Vector2f normal;
+};
+
+/**
+ * Sparse uniform grid of circles, keyed by cell coordinates.
+ *
+ * Bodies are updated in place every step and only move between cells when they cross a cell border,
+ * so the grid is never rebuilt. The query methods are const and can run concurrently with each other,
+ * but not with Update or Remove.
+ */
+class SpatialHashGrid {
+ public:
+  explicit SpatialHashGrid(float cellSize = 64.f);
+
+  // Inserts the entity or moves it to its new position
+  void Update(flecs::entity_t entity, sf::Vector2f position, float radius);
+  void Remove(flecs::entity_t entity);
+
+  [[nodiscard]] std::size_t GetSize() const { return locations.size(); }
+
+  // The body containing the point with the closest center
+  [[nodiscard]] std::optional<flecs::entity_t> PointPick(sf::Vector2f point) const;
+
+  // Appends the bodies overlapping the shape to out
+  void OverlapCircle(sf::Vector2f center, float radius, std::vector<flecs::entity_t>& out) const;
+  void OverlapRect(const sf::FloatRect& rect, std::vector<flecs::entity_t>& out) const;
+
+  // direction does not need to be normalized, maxDistance must be finite
+  [[nodiscard]] std::optional<RaycastHit> Raycast(sf::Vector2f origin, sf::Vector2f direction,
+                                                  float maxDistance) const;
+
+  // Appends every hit to out, sorted by distance
+  void RaycastAll(sf::Vector2f origin, sf::Vector2f direction, float maxDistance,
+                  std::vector<RaycastHit>& out) const;
+
+ private:
+  struct Entry {
+    flecs::entity_t entity;
+    sf::Vector2f position;
+    float radius;
+  };
+
+  struct Location {
+    std::int64_t cell;
+    std::uint32_t slot;
+  };
+
+  struct CellCoordinates {
+    int x;
+    int y;
+  };
+
+  [[nodiscard]] CellCoordinates GetCellCoordinates(sf::Vector2f position) const;
+  [[nodiscard]] static std::int64_t GetCellKey(CellCoordinates coordinates);
+  [[nodiscard]] static CellCoordinates GetCellCoordinates(std::int64_t key);
+
+  // Calls fn(entry) for every body whose cell is in the inclusive range
+  template <typename Fn>
+  void ForEachInCells(CellCoordinates min, CellCoordinates max, Fn&& fn) const;
+
+  // Walks the cells along a normalized ray, calls onEntry for the bodies that may cross it and stops once
+  // shouldStop(distance traveled) returns true, maxDistance is reached or the ray leaves the occupied cells
+  template <typename OnEntry, typename ShouldStop>
+  void TraverseRay(sf::Vector2f origin, sf::Vector2f direction, float maxDistance, OnEntry&& onEntry,
+                   ShouldStop&& shouldStop) const;
+
+  void RemoveFromCell(const Location& location);
+
+  void AddOccupiedCell(std::int64_t key);
+  void RemoveOccupiedCell(std::int64_t key);
+
+  float cellSize;
+  float inverseCellSize;
+  // largest radius ever inserted, queries look that far around the cells they touch
+  float maxRadius = 0.f;
+
+  std::unordered_map<std::int64_t, std::vector<Entry>> cells;
+  std::unordered_map<flecs::entity_t, Location> locations;
+
+  // number of occupied cells per column and per row, their first and last keys bound every body
+  std::map<int, std::uint32_t> occupiedColumns;
+  std::map<int, std::uint32_t> occupiedRows;
+};
@@ -0,0 +1,43 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+#include <flecs.h>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "PhysicsModule/Spatial/SpatialHashGrid.h"
+
+struct Ray {
+  sf::Vector2f origin;
+  sf::Vector2f direction;
+  float maxDistance = 10000.f;
+};
+
+/**
+ * Queries against the SpatialIndex of a world. They all return nothing when the world has no index.
+ *
+ * The index reflects the world at the end of the last step, queries are read-only and can be issued
+ * from any thread between two calls to progress().
+ */
+struct SpatialQuery {
+  static std::optional<flecs::entity_t> PointPick(const flecs::world& world, sf::Vector2f point);
+
+  static void OverlapCircle(const flecs::world& world, sf::Vector2f center, float radius,
+                            std::vector<flecs::entity_t>& out);
+  static void OverlapRect(const flecs::world& world, const sf::FloatRect& rect, std::vector<flecs::entity_t>& out);
+
+  static std::optional<RaycastHit> Raycast(const flecs::world& world, const Ray& ray);
+  static void RaycastAll(const flecs::world& world, const Ray& ray, std::vector<RaycastHit>& out);
+
+  // Batches are answered in parallel on the PhysicsSettings job system when there is one,
+  // the output spans must be as large as the input spans
+  static void PointPickBatch(const flecs::world& world, std::span<const sf::Vector2f> points,
+                             std::span<std::optional<flecs::entity_t>> picked);
+  static void RaycastBatch(const flecs::world& world, std::span<const Ray> rays,
+                           std::span<std::optional<RaycastHit>> hits);
+};
@@ -0,0 +1,16 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+#include <flecs.h>
+#include <SFML/Graphics/Rect.hpp>
+
+struct RigidBody;
+struct Transform;
+
+struct ResolveBoundaryCollision {
+  static void Register(const flecs::world& world);
+
+  // Bounces a circle back inside the bounds, also used by the integrator between substeps
+  static void Resolve(const sf::FloatRect& bounds, float radius, float restitution, Transform& t, RigidBody& p);
+};
@@ -0,0 +1,9 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+#include <flecs.h>
+
+struct SortByMortonCode {
+  static void Register(const flecs::world& world);
+};
@@ -0,0 +1,198 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#include "Trajectory/MappedFile.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Core/Utilities/Logger.h"
+
+#if defined(_WIN32)
+
+std::unique_ptr<MappedFile> MappedFile::Create(const std::string& path, const std::size_t size) {
+  std::unique_ptr<MappedFile> mappedFile(new MappedFile());
+  mappedFile->path = path;
+  mappedFile->writable = true;
+  mappedFile->file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+                                 FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (mappedFile->file == INVALID_HANDLE_VALUE) {
+    mappedFile->file = nullptr;
+    LOG_ERROR("Unable to create {}", path);
+    return nullptr;
+  }
+
+  if (!mappedFile->Resize(size))
+    return nullptr;
+
+  return mappedFile;
+}
+
+std::unique_ptr<MappedFile> MappedFile::OpenReadOnly(const std::string& path) {
+  std::unique_ptr<MappedFile> mappedFile(new MappedFile());
+  mappedFile->path = path;
+  mappedFile->file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (mappedFile->file == INVALID_HANDLE_VALUE) {
+    mappedFile->file = nullptr;
+    LOG_ERROR("Unable to open {}", path);
+    return nullptr;
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(mappedFile->file, &fileSize)) {
+    LOG_ERROR("Unable to read the size of {}", path);
+    return nullptr;
+  }
+
+  mappedFile->size = static_cast<std::size_t>(fileSize.QuadPart);
+  if (!mappedFile->Map())
+    return nullptr;
+
+  return mappedFile;
+}
+
+MappedFile::~MappedFile() {
+  Unmap();
+  if (file)
+    CloseHandle(file);
+}
+
+bool MappedFile::Resize(const std::size_t newSize) {
+  if (!writable)
+    return false;
+
+  Unmap();
+
+  LARGE_INTEGER distance;
+  distance.QuadPart = static_cast<LONGLONG>(newSize);
+  if (!SetFilePointerEx(file, distance, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+    LOG_ERROR("Unable to resize {} to {} bytes", path, newSize);
+    return false;
+  }
+
+  size = newSize;
+  return Map();
+}
+
+bool MappedFile::Map() {
+  // Windows refuses to map an empty file
+  if (size == 0)
+    return true;
+
+  mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping) {
+    LOG_ERROR("Unable to map {}", path);
+    return false;
+  }
+
+  data = static_cast<std::byte*>(MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size));
+  if (!data) {
+    LOG_ERROR("Unable to map a view of {}", path);
+    return false;
+  }
+
+  return true;
+}
+
+void MappedFile::Unmap() {
+  if (data)
+    UnmapViewOfFile(data);
+  if (mapping)
+    CloseHandle(mapping);
+
+  data = nullptr;
+  mapping = nullptr;
+}
+
+#else
+
+std::unique_ptr<MappedFile> MappedFile::Create(const std::string& path, const std::size_t size) {
+  std::unique_ptr<MappedFile> mappedFile(new MappedFile());
+  mappedFile->path = path;
+  mappedFile->writable = true;
+  mappedFile->file = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (mappedFile->file < 0) {
+    LOG_ERROR("Unable to create {}", path);
+    return nullptr;
+  }
+
+  if (!mappedFile->Resize(size))
+    return nullptr;
+
+  return mappedFile;
+}
+
+std::unique_ptr<MappedFile> MappedFile::OpenReadOnly(const std::string& path) {
+  std::unique_ptr<MappedFile> mappedFile(new MappedFile());
+  mappedFile->path = path;
+  mappedFile->file = open(path.c_str(), O_RDONLY);
+  if (mappedFile->file < 0) {
+    LOG_ERROR("Unable to open {}", path);
+    return nullptr;
+  }
+
+  struct stat status {};
+  if (fstat(mappedFile->file, &status) != 0) {
+    LOG_ERROR("Unable to read the size of {}", path);
+    return nullptr;
+  }
+
+  mappedFile->size = static_cast<std::size_t>(status.st_size);
+  if (!mappedFile->Map())
+    return nullptr;
+
+  return mappedFile;
+}
+
+MappedFile::~MappedFile() {
+  Unmap();
+  if (file >= 0)
+    close(file);
+}
+
+bool MappedFile::Resize(const std::size_t newSize) {
+  if (!writable)
+    return false;
+
+  Unmap();
+
+  if (ftruncate(file, static_cast<off_t>(newSize)) != 0) {
+    LOG_ERROR("Unable to resize {} to {} bytes", path, newSize);
+    return false;
+  }
+
+  size = newSize;
+  return Map();
+}
+
+bool MappedFile::Map() {
+  // mmap refuses a length of zero
+  if (size == 0)
+    return true;
+
+  void* address = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, file, 0);
+  if (address == MAP_FAILED) {
+    LOG_ERROR("Unable to map {}", path);
+    return false;
+  }
+
+  data = static_cast<std::byte*>(address);
+  return true;
+}
+
+void MappedFile::Unmap() {
+  if (data)
+    munmap(data, size);
+
+  data = nullptr;
+}
+
+#endif
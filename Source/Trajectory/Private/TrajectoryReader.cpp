@@ -0,0 +1,101 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#include "Trajectory/TrajectoryReader.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "Core/Utilities/Logger.h"
+#include "Trajectory/MappedFile.h"
+
+float TrajectoryStep::GetValue(const TrajectoryColumn column, const std::size_t index) const {
+  assert(index < entities.size());
+  const auto c = static_cast<std::size_t>(column);
+
+  if (encoding == TrajectoryEncoding::Quantized16) {
+    const auto quantized = reinterpret_cast<const std::uint16_t*>(columns[c])[index];
+    return header->columnMin[c] + static_cast<float>(quantized) * header->columnScale[c];
+  }
+
+  return reinterpret_cast<const float*>(columns[c])[index];
+}
+
+void TrajectoryStep::ReadColumn(const TrajectoryColumn column, const std::span<float> out) const {
+  assert(out.size() >= entities.size());
+  const auto c = static_cast<std::size_t>(column);
+
+  if (encoding == TrajectoryEncoding::Quantized16) {
+    const auto* quantized = reinterpret_cast<const std::uint16_t*>(columns[c]);
+    for (std::size_t i = 0; i < entities.size(); ++i) {
+      out[i] = header->columnMin[c] + static_cast<float>(quantized[i]) * header->columnScale[c];
+    }
+    return;
+  }
+
+  std::memcpy(out.data(), columns[c], sizeof(float) * entities.size());
+}
+
+std::unique_ptr<TrajectoryReader> TrajectoryReader::Open(const std::string& path) {
+  auto file = MappedFile::OpenReadOnly(path);
+  if (!file)
+    return nullptr;
+
+  TrajectoryFileHeader header;
+  if (file->GetSize() < sizeof(header)) {
+    LOG_ERROR("{} is too small to be a trajectory file", path);
+    return nullptr;
+  }
+
+  std::memcpy(&header, file->GetData(), sizeof(header));
+  if (header.magic != TrajectoryFormat::FILE_MAGIC || header.version != TrajectoryFormat::VERSION) {
+    LOG_ERROR("{} is not a trajectory file of version {}", path, TrajectoryFormat::VERSION);
+    return nullptr;
+  }
+
+  if (header.dataEnd > file->GetSize()) {
+    LOG_ERROR("{} is truncated", path);
+    return nullptr;
+  }
+
+  return std::unique_ptr<TrajectoryReader>(new TrajectoryReader(std::move(file), header));
+}
+
+TrajectoryReader::TrajectoryReader(std::unique_ptr<MappedFile> file, const TrajectoryFileHeader& header)
+    : file(std::move(file)), header(header) {}
+
+TrajectoryReader::~TrajectoryReader() = default;
+
+bool TrajectoryReader::Next(TrajectoryStep& step) {
+  if (offset + sizeof(TrajectoryChunkHeader) > header.dataEnd)
+    return false;
+
+  const std::byte* chunk = file->GetData() + offset;
+  const auto* chunkHeader = reinterpret_cast<const TrajectoryChunkHeader*>(chunk);
+  if (chunkHeader->magic != TrajectoryFormat::CHUNK_MAGIC ||
+      chunkHeader->payloadSize > header.dataEnd - offset - sizeof(TrajectoryChunkHeader)) {
+    LOG_ERROR("Corrupted trajectory chunk at offset {}", offset);
+    return false;
+  }
+
+  const std::size_t bodyCount = chunkHeader->bodyCount;
+  const std::size_t valueSize = header.encoding == TrajectoryEncoding::Quantized16 ? sizeof(std::uint16_t)
+                                                                                   : sizeof(float);
+  const std::size_t entitiesSize = TrajectoryFormat::Align(sizeof(std::uint64_t) * bodyCount);
+  const std::size_t columnSize = TrajectoryFormat::Align(valueSize * bodyCount);
+  if (chunkHeader->payloadSize < entitiesSize + TRAJECTORY_COLUMN_COUNT * columnSize) {
+    LOG_ERROR("Corrupted trajectory chunk at offset {}, {} bodies do not fit in {} bytes", offset, bodyCount,
+              chunkHeader->payloadSize);
+    return false;
+  }
+
+  const std::byte* payload = chunk + sizeof(TrajectoryChunkHeader);
+  step.header = chunkHeader;
+  step.encoding = header.encoding;
+  step.entities = {reinterpret_cast<const std::uint64_t*>(payload), bodyCount};
+  for (std::size_t column = 0; column < TRAJECTORY_COLUMN_COUNT; ++column) {
+    step.columns[column] = payload + entitiesSize + column * columnSize;
+  }
+
+  offset += sizeof(TrajectoryChunkHeader) + chunkHeader->payloadSize;
+  return true;
+}
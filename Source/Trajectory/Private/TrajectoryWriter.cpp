@@ -0,0 +1,180 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#include "Trajectory/TrajectoryWriter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "Core/Utilities/Logger.h"
+#include "Trajectory/MappedFile.h"
+
+namespace {
+
+// The file grows by doubling, starting from this size
+constexpr std::size_t INITIAL_FILE_SIZE = 64 * 1024 * 1024;
+
+constexpr float QUANTIZED_RANGE = 65535.f;
+
+std::size_t GetColumnSize(const TrajectoryEncoding encoding, const std::size_t bodyCount) {
+  const std::size_t valueSize = encoding == TrajectoryEncoding::Quantized16 ? sizeof(std::uint16_t) : sizeof(float);
+  return TrajectoryFormat::Align(valueSize * bodyCount);
+}
+
+void QuantizeColumn(const std::vector<float>& values, float& min, float& scale, std::uint16_t* out) {
+  min = 0.f;
+  scale = 0.f;
+  if (values.empty())
+    return;
+
+  const auto [low, high] = std::minmax_element(values.begin(), values.end());
+  min = *low;
+  scale = (*high - *low) / QUANTIZED_RANGE;
+
+  if (scale <= 0.f) {
+    std::fill_n(out, values.size(), std::uint16_t{0});
+    return;
+  }
+
+  const float inverseScale = 1.f / scale;
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    const float quantized = std::clamp((values[i] - min) * inverseScale, 0.f, QUANTIZED_RANGE);
+    out[i] = static_cast<std::uint16_t>(std::lround(quantized));
+  }
+}
+
+}  // namespace
+
+void TrajectoryFrame::Resize(const std::size_t bodyCount) {
+  entities.resize(bodyCount);
+  for (auto& column : columns) {
+    column.resize(bodyCount);
+  }
+}
+
+std::unique_ptr<TrajectoryWriter> TrajectoryWriter::Open(const std::string& path, const TrajectoryEncoding encoding) {
+  auto file = MappedFile::Create(path, INITIAL_FILE_SIZE);
+  if (!file)
+    return nullptr;
+
+  return std::unique_ptr<TrajectoryWriter>(new TrajectoryWriter(std::move(file), encoding));
+}
+
+TrajectoryWriter::TrajectoryWriter(std::unique_ptr<MappedFile> file, const TrajectoryEncoding encoding)
+    : file(std::move(file)), encoding(encoding) {
+  TrajectoryFileHeader header;
+  header.encoding = encoding;
+  std::memcpy(this->file->GetData(), &header, sizeof(header));
+
+  writer = std::thread([this] { WriterLoop(); });
+}
+
+TrajectoryWriter::~TrajectoryWriter() {
+  {
+    std::lock_guard lock(mutex);
+    stopping = true;
+  }
+  frameSubmitted.notify_all();
+  writer.join();
+
+  // Drop the unused tail of the last growth
+  file->Resize(dataEnd);
+}
+
+TrajectoryFrame TrajectoryWriter::AcquireFrame() {
+  std::lock_guard lock(mutex);
+  if (recycled.empty())
+    return {};
+
+  TrajectoryFrame frame = std::move(recycled.back());
+  recycled.pop_back();
+  return frame;
+}
+
+void TrajectoryWriter::Submit(TrajectoryFrame&& frame) {
+  {
+    std::unique_lock lock(mutex);
+    frameWritten.wait(lock, [this] { return pending.size() < MAX_PENDING_FRAMES; });
+    pending.push_back(std::move(frame));
+  }
+  frameSubmitted.notify_one();
+}
+
+void TrajectoryWriter::WriterLoop() {
+  while (true) {
+    TrajectoryFrame frame;
+    {
+      std::unique_lock lock(mutex);
+      frameSubmitted.wait(lock, [this] { return stopping || !pending.empty(); });
+      if (pending.empty())
+        return;
+
+      frame = std::move(pending.front());
+      pending.pop_front();
+    }
+    frameWritten.notify_one();
+
+    if (!failed && !WriteFrame(frame)) {
+      failed = true;
+      LOG_ERROR("Trajectory recording stopped at step {}", frame.step);
+    }
+
+    std::lock_guard lock(mutex);
+    recycled.push_back(std::move(frame));
+  }
+}
+
+bool TrajectoryWriter::WriteFrame(const TrajectoryFrame& frame) {
+  const std::size_t bodyCount = frame.entities.size();
+  const std::size_t entitiesSize = TrajectoryFormat::Align(sizeof(std::uint64_t) * bodyCount);
+  const std::size_t columnSize = GetColumnSize(encoding, bodyCount);
+  const std::size_t payloadSize = entitiesSize + columnSize * TRAJECTORY_COLUMN_COUNT;
+
+  if (!Reserve(sizeof(TrajectoryChunkHeader) + payloadSize))
+    return false;
+
+  std::byte* chunk = file->GetData() + dataEnd;
+  std::byte* payload = chunk + sizeof(TrajectoryChunkHeader);
+
+  TrajectoryChunkHeader header;
+  header.bodyCount = static_cast<std::uint32_t>(bodyCount);
+  header.step = frame.step;
+  header.time = frame.time;
+  header.payloadSize = payloadSize;
+
+  std::memcpy(payload, frame.entities.data(), sizeof(std::uint64_t) * bodyCount);
+
+  for (std::size_t column = 0; column < TRAJECTORY_COLUMN_COUNT; ++column) {
+    std::byte* out = payload + entitiesSize + column * columnSize;
+    if (encoding == TrajectoryEncoding::Quantized16) {
+      QuantizeColumn(frame.columns[column], header.columnMin[column], header.columnScale[column],
+                     reinterpret_cast<std::uint16_t*>(out));
+    } else {
+      std::memcpy(out, frame.columns[column].data(), sizeof(float) * bodyCount);
+    }
+  }
+
+  std::memcpy(chunk, &header, sizeof(header));
+
+  // Publish the chunk in the file header last, an interrupted recording only exposes complete chunks
+  dataEnd += sizeof(TrajectoryChunkHeader) + payloadSize;
+  ++chunkCount;
+
+  auto* fileHeader = reinterpret_cast<TrajectoryFileHeader*>(file->GetData());
+  fileHeader->chunkCount = chunkCount;
+  fileHeader->dataEnd = dataEnd;
+
+  return true;
+}
+
+bool TrajectoryWriter::Reserve(const std::size_t bytes) {
+  if (dataEnd + bytes <= file->GetSize())
+    return true;
+
+  std::size_t newSize = std::max<std::size_t>(file->GetSize(), INITIAL_FILE_SIZE);
+  while (newSize < dataEnd + bytes) {
+    newSize *= 2;
+  }
+
+  return file->Resize(newSize);
+}
@@ -0,0 +1,46 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/**
+ * A file mapped in memory. Writable files can grow, the mapping is recreated so any pointer
+ * obtained before a Resize is invalidated.
+ */
+class MappedFile {
+ public:
+  // Returns nullptr and logs an error when the file cannot be created or mapped
+  static std::unique_ptr<MappedFile> Create(const std::string& path, std::size_t size);
+  static std::unique_ptr<MappedFile> OpenReadOnly(const std::string& path);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool Resize(std::size_t newSize);
+
+  [[nodiscard]] std::byte* GetData() const { return data; }
+  [[nodiscard]] std::size_t GetSize() const { return size; }
+
+ private:
+  MappedFile() = default;
+
+  bool Map();
+  void Unmap();
+
+  std::string path;
+  std::byte* data = nullptr;
+  std::size_t size = 0;
+  bool writable = false;
+
+#if defined(_WIN32)
+  void* file = nullptr;
+  void* mapping = nullptr;
+#else
+  int file = -1;
+#endif
+};
@@ -0,0 +1,72 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Layout of a trajectory file:
+ *
+ *   TrajectoryFileHeader
+ *   TrajectoryChunkHeader, payload    <- one chunk per recorded step
+ *   TrajectoryChunkHeader, payload
+ *   ...
+ *
+ * The payload is columnar: the entity ids first, then one column per TrajectoryColumn. Every column starts on
+ * an 8 bytes boundary so the reader can hand out typed pointers straight into the mapping.
+ */
+namespace TrajectoryFormat {
+
+constexpr std::uint32_t FILE_MAGIC = 0x4A415254;   // "TRAJ"
+constexpr std::uint32_t CHUNK_MAGIC = 0x4B4E4843;  // "CHNK"
+constexpr std::uint32_t VERSION = 1;
+constexpr std::size_t ALIGNMENT = 8;
+
+constexpr std::size_t Align(const std::size_t size) {
+  return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+}  // namespace TrajectoryFormat
+
+enum struct TrajectoryEncoding : std::uint32_t {
+  // 32 bits floats, exact
+  Raw = 0,
+  // 16 bits per value, linearly mapped between the min and max of the column in the chunk
+  Quantized16 = 1,
+};
+
+enum struct TrajectoryColumn : std::uint32_t {
+  PositionX = 0,
+  PositionY,
+  VelocityX,
+  VelocityY,
+  Count
+};
+
+constexpr std::size_t TRAJECTORY_COLUMN_COUNT = static_cast<std::size_t>(TrajectoryColumn::Count);
+
+struct TrajectoryFileHeader {
+  std::uint32_t magic = TrajectoryFormat::FILE_MAGIC;
+  std::uint32_t version = TrajectoryFormat::VERSION;
+  TrajectoryEncoding encoding = TrajectoryEncoding::Raw;
+  std::uint32_t reserved = 0;
+  // updated after every chunk, a reader never looks past dataEnd
+  std::uint64_t chunkCount = 0;
+  std::uint64_t dataEnd = sizeof(TrajectoryFileHeader);
+};
+
+struct TrajectoryChunkHeader {
+  std::uint32_t magic = TrajectoryFormat::CHUNK_MAGIC;
+  std::uint32_t bodyCount = 0;
+  std::uint64_t step = 0;
+  double time = 0.;
+  // size of the payload following this header, also the offset to the next chunk
+  std::uint64_t payloadSize = 0;
+  // value = min + quantized * scale, only used by Quantized16
+  float columnMin[TRAJECTORY_COLUMN_COUNT] = {};
+  float columnScale[TRAJECTORY_COLUMN_COUNT] = {};
+};
+
+static_assert(sizeof(TrajectoryFileHeader) % TrajectoryFormat::ALIGNMENT == 0);
+static_assert(sizeof(TrajectoryChunkHeader) % TrajectoryFormat::ALIGNMENT == 0);
@@ -0,0 +1,64 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+#include "Trajectory/TrajectoryFormat.h"
+
+class MappedFile;
+
+/**
+ * View of one recorded step. It points straight into the mapping, so it is only valid as long as
+ * the reader that produced it.
+ */
+struct TrajectoryStep {
+  const TrajectoryChunkHeader* header = nullptr;
+  TrajectoryEncoding encoding = TrajectoryEncoding::Raw;
+  std::span<const std::uint64_t> entities;
+  const std::byte* columns[TRAJECTORY_COLUMN_COUNT] = {};
+
+  [[nodiscard]] std::uint64_t GetStep() const { return header->step; }
+  [[nodiscard]] double GetTime() const { return header->time; }
+  [[nodiscard]] std::size_t GetBodyCount() const { return entities.size(); }
+
+  // Decodes a single value
+  [[nodiscard]] float GetValue(TrajectoryColumn column, std::size_t index) const;
+
+  // Decodes a whole column, out must hold GetBodyCount() values
+  void ReadColumn(TrajectoryColumn column, std::span<float> out) const;
+};
+
+/**
+ * Scans a trajectory file chunk by chunk. The file is memory-mapped, only the pages of the
+ * chunks actually visited are loaded.
+ */
+class TrajectoryReader {
+ public:
+  // Returns nullptr and logs an error when the file is missing or is not a trajectory file
+  static std::unique_ptr<TrajectoryReader> Open(const std::string& path);
+
+  ~TrajectoryReader();
+
+  TrajectoryReader(const TrajectoryReader&) = delete;
+  TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+
+  [[nodiscard]] TrajectoryEncoding GetEncoding() const { return header.encoding; }
+  [[nodiscard]] std::uint64_t GetChunkCount() const { return header.chunkCount; }
+
+  // Moves to the next step, returns false at the end of the file
+  bool Next(TrajectoryStep& step);
+
+  // Goes back to the first step
+  void Rewind() { offset = sizeof(TrajectoryFileHeader); }
+
+ private:
+  TrajectoryReader(std::unique_ptr<MappedFile> file, const TrajectoryFileHeader& header);
+
+  std::unique_ptr<MappedFile> file;
+  TrajectoryFileHeader header;
+  std::uint64_t offset = sizeof(TrajectoryFileHeader);
+};
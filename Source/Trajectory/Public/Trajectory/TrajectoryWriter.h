@@ -0,0 +1,74 @@
+// Copyright (c) Eric Jeker. All Rights Reserved.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Trajectory/TrajectoryFormat.h"
+
+class MappedFile;
+
+// One recorded step, the columns are indexed by TrajectoryColumn
+struct TrajectoryFrame {
+  std::uint64_t step = 0;
+  double time = 0.;
+  std::vector<std::uint64_t> entities;
+  std::vector<float> columns[TRAJECTORY_COLUMN_COUNT];
+
+  void Resize(std::size_t bodyCount);
+};
+
+/**
+ * Appends steps to a trajectory file from a background thread.
+ *
+ * The simulation thread only copies its columns into a TrajectoryFrame and submits it. Encoding and writing
+ * into the memory-mapped file happen on the writer thread, frames are then recycled to avoid allocations.
+ */
+class TrajectoryWriter {
+ public:
+  // Returns nullptr and logs an error when the file cannot be created
+  static std::unique_ptr<TrajectoryWriter> Open(const std::string& path, TrajectoryEncoding encoding);
+
+  // Writes the pending frames and trims the file to its content
+  ~TrajectoryWriter();
+
+  TrajectoryWriter(const TrajectoryWriter&) = delete;
+  TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+  // Hands out a recycled frame when one is available
+  TrajectoryFrame AcquireFrame();
+
+  // Blocks only when the writer is MAX_PENDING_FRAMES behind
+  void Submit(TrajectoryFrame&& frame);
+
+ private:
+  static constexpr std::size_t MAX_PENDING_FRAMES = 8;
+
+  TrajectoryWriter(std::unique_ptr<MappedFile> file, TrajectoryEncoding encoding);
+
+  void WriterLoop();
+  bool WriteFrame(const TrajectoryFrame& frame);
+  bool Reserve(std::size_t bytes);
+
+  std::unique_ptr<MappedFile> file;
+  TrajectoryEncoding encoding;
+  std::uint64_t dataEnd = sizeof(TrajectoryFileHeader);
+  std::uint64_t chunkCount = 0;
+  bool failed = false;
+
+  std::mutex mutex;
+  std::condition_variable frameSubmitted;
+  std::condition_variable frameWritten;
+  std::deque<TrajectoryFrame> pending;
+  std::vector<TrajectoryFrame> recycled;
+  bool stopping = false;
+
+  std::thread writer;
+};